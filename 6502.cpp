@@ -23,176 +23,307 @@ using namespace BaseLogic;
 
 namespace M6502Core
 {
+	// The bitmask corresponds to the values from the Breaking NES Wiki:
+	// https://github.com/emu-russia/breaks/blob/master/BreakingNESWiki_DeepL/6502/decoder.md
+
+	static constexpr size_t decoder_bitmask[Decoder::outputs_count] = {
+		// A
+		0b000101100000100100000,
+		0b000000010110001000100,
+		0b000000011010001001000,
+		0b010100011001100100000,
+		0b010101011010100100000,
+		0b010110000001100100000,
+
+		// B
+		0b000000100010000001000,
+		0b000001000000100010000,
+		0b000000010101001001000,
+		0b010101011001100010000,
+		0b010110011001100010000,
+		0b011010000001100100000,
+		0b000101000000100010000,
+		0b010101011010100010000,
+		0b011001000000100010000,
+		0b100110011001100010000,
+		0b101010011001100100000,
+		0b011001011010100010000,
+		0b100100011001100100000,
+		0b011001100000100100000,
+		0b011001000001100100000,
+
+		// C
+		0b011001010101010100000,
+		0b000101010101010100001,
+		0b010100011001010100000,
+		0b001010010101010100010,
+		0b001000011001010100100,
+		0b000110010101010100001,
+		0b001010000000010010000,
+		0b000000000000000001000,
+		0b010110000000011000000,
+		0b000010101001010100000,
+		0b000000101001000001000,
+		0b010101000000011000000,
+		0b000000000100000001000,
+		0b010000000000000000000,
+		0b000000010001010101000,
+		0b000000000001010100100,
+
+		// D
+		0b000001010101010100010,
+		0b000110010101010100010,
+		0b000000010101001000100,
+		0b000000010110001000010,
+		0b000000010110001001000,
+		0b000000001010000000100,
+		0b001000011001010100000,
+		0b001010000000100010000,
+		0b000000010101001000010,
+		0b000000010110001000100,
+		0b000010010101010100000,
+		0b001001010101010101000,
+		0b010010000001100100000,
+		0b010110000000101000000,
+		0b011010000000101000000,
+		0b011010000000001000000,
+		0b001001000000010010000,
+
+		// E
+		0b000010101001010100100,
+		0b000001000000010010000,
+		0b001001010101010100001,
+		0b000000010001010101000,
+		0b010101011010100100000,
+		0b100000000000011000000,
+		0b101010000000001000000,
+		0b100000011001010010000,
+		0b010101011001100010000,
+		0b011010011001010100000,
+		0b011001000000101000000,
+		0b010000000000001000000,
+		0b011001011001100100000,
+		0b010000011001010010000,
+		0b011001011001100010000,
+		0b011001100001010100000,
+		0b011001000000011000000,
+		0b000000001010000000010,
+		0b000000010110001000001,
+
+		// F
+		0b010000010110000100000,
+		0b000110011001010101000,
+		0b010010011001010010000,
+		0b000010000000010010000,
+		0b000101010101010101000,
+		0b001001010101010100100,
+		0b000101000000101000000,
+		0b000000010110000101000,
+		0b000000100100000001000,
+		0b000000010100001001000,
+		0b000000001000000001000,
+		0b001010010101010100001,
+		0b000000000000000000010,
+		0b000000000000000000100,
+		0b010100010101010100000,
+		0b010010101001010100000,
+		0b000000010101001000001,
+		0b000000001000000000100,
+
+		// G
+		0b000000010110001000010,
+		0b000000001010000000100,
+		0b000000010110000100100,
+		0b000100010101010100000,
+		0b001001010101010100000,
+		0b000010101001010100000,
+		0b000101000000100000000,
+		0b000101010101010100010,
+		0b000101011001010101000,
+		0b000100011001010101000,
+		0b000010101001010100010,
+		0b000010010101010100001,
+		0b001001010101010100001,
+
+		// H
+		0b000110101001010101000,
+		0b001000011001010100100,
+		0b000010000000000010000,
+		0b000001000000010010000,
+		0b010010011010010100000,
+		0b101001100001010100000,
+		0b010001011010010100000,
+		0b000000100110000000100,
+		0b101010000000001000000,
+		0b011001100001010100000,
+		0b011001011001010100000,
+		0b000110010101010100010,
+		0b100110000000101000000,
+		0b100010101001100100000,
+		0b100001011001010010000,
+		0b100010000101100100000,
+
+		// K
+		0b010010011010100100000,
+		0b000001000000000000000,
+		0b000000101001000000100,
+		0b000000100101000001000,
+		0b000000010100001000001,
+		0b000000001010000000010,
+		0b000000000000010000000,
+		0b001001011010100100000,
+		0b000000011000000000000,
+		0b000000011001010100000,		// pp
+	};
+
+	// The msb of a bitmask corresponds to the input bit 0 (n_T1X), see DecoderInput.
+
+	static constexpr size_t DecoderTermInputs(size_t bitmask)
+	{
+		size_t inputs = 0;
+		for (size_t bit = 0; bit < Decoder::inputs_count; bit++)
+		{
+			if (bitmask & (1ULL << (Decoder::inputs_count - bit - 1)))
+			{
+				inputs |= 1ULL << bit;
+			}
+		}
+		return inputs;
+	}
+
+	struct DecoderTerms
+	{
+		size_t inputs[Decoder::outputs_count];
+	};
+
+	static constexpr DecoderTerms MakeDecoderTerms()
+	{
+		DecoderTerms terms{};
+		for (size_t out = 0; out < Decoder::outputs_count; out++)
+		{
+			terms.inputs[out] = DecoderTermInputs(decoder_bitmask[out]);
+		}
+		return terms;
+	}
+
+	// The decoder inputs that ground each output.
+
+	static constexpr DecoderTerms decoder_terms = MakeDecoderTerms();
+
 	Decoder::Decoder()
 	{
-		pla = new PLA(inputs_count, outputs_count, (char*)"Decoder6502.bin");
-
-		// The bitmask corresponds to the values from the Breaking NES Wiki:
-		// https://github.com/emu-russia/breaks/blob/master/BreakingNESWiki_DeepL/6502/decoder.md
-
-		static size_t bitmask[outputs_count] = {
-			// A
-			0b000101100000100100000,
-			0b000000010110001000100,
-			0b000000011010001001000,
-			0b010100011001100100000,
-			0b010101011010100100000,
-			0b010110000001100100000,
-
-			// B
-			0b000000100010000001000,
-			0b000001000000100010000,
-			0b000000010101001001000,
-			0b010101011001100010000,
-			0b010110011001100010000,
-			0b011010000001100100000,
-			0b000101000000100010000,
-			0b010101011010100010000,
-			0b011001000000100010000,
-			0b100110011001100010000,
-			0b101010011001100100000,
-			0b011001011010100010000,
-			0b100100011001100100000,
-			0b011001100000100100000,
-			0b011001000001100100000,
-
-			// C
-			0b011001010101010100000,
-			0b000101010101010100001,
-			0b010100011001010100000,
-			0b001010010101010100010,
-			0b001000011001010100100,
-			0b000110010101010100001,
-			0b001010000000010010000,
-			0b000000000000000001000,
-			0b010110000000011000000,
-			0b000010101001010100000,
-			0b000000101001000001000,
-			0b010101000000011000000,
-			0b000000000100000001000,
-			0b010000000000000000000,
-			0b000000010001010101000,
-			0b000000000001010100100,
-
-			// D
-			0b000001010101010100010,
-			0b000110010101010100010,
-			0b000000010101001000100,
-			0b000000010110001000010,
-			0b000000010110001001000,
-			0b000000001010000000100,
-			0b001000011001010100000,
-			0b001010000000100010000,
-			0b000000010101001000010,
-			0b000000010110001000100,
-			0b000010010101010100000,
-			0b001001010101010101000,
-			0b010010000001100100000,
-			0b010110000000101000000,
-			0b011010000000101000000,
-			0b011010000000001000000,
-			0b001001000000010010000,
-
-			// E
-			0b000010101001010100100,
-			0b000001000000010010000,
-			0b001001010101010100001,
-			0b000000010001010101000,
-			0b010101011010100100000,
-			0b100000000000011000000,
-			0b101010000000001000000,
-			0b100000011001010010000,
-			0b010101011001100010000,
-			0b011010011001010100000,
-			0b011001000000101000000,
-			0b010000000000001000000,
-			0b011001011001100100000,
-			0b010000011001010010000,
-			0b011001011001100010000,
-			0b011001100001010100000,
-			0b011001000000011000000,
-			0b000000001010000000010,
-			0b000000010110001000001,
-
-			// F
-			0b010000010110000100000,
-			0b000110011001010101000,
-			0b010010011001010010000,
-			0b000010000000010010000,
-			0b000101010101010101000,
-			0b001001010101010100100,
-			0b000101000000101000000,
-			0b000000010110000101000,
-			0b000000100100000001000,
-			0b000000010100001001000,
-			0b000000001000000001000,
-			0b001010010101010100001,
-			0b000000000000000000010,
-			0b000000000000000000100,
-			0b010100010101010100000,
-			0b010010101001010100000,
-			0b000000010101001000001,
-			0b000000001000000000100,
-
-			// G
-			0b000000010110001000010,
-			0b000000001010000000100,
-			0b000000010110000100100,
-			0b000100010101010100000,
-			0b001001010101010100000,
-			0b000010101001010100000,
-			0b000101000000100000000,
-			0b000101010101010100010,
-			0b000101011001010101000,
-			0b000100011001010101000,
-			0b000010101001010100010,
-			0b000010010101010100001,
-			0b001001010101010100001,
-
-			// H
-			0b000110101001010101000,
-			0b001000011001010100100,
-			0b000010000000000010000,
-			0b000001000000010010000,
-			0b010010011010010100000,
-			0b101001100001010100000,
-			0b010001011010010100000,
-			0b000000100110000000100,
-			0b101010000000001000000,
-			0b011001100001010100000,
-			0b011001011001010100000,
-			0b000110010101010100010,
-			0b100110000000101000000,
-			0b100010101001100100000,
-			0b100001011001010010000,
-			0b100010000101100100000,
-
-			// K
-			0b010010011010100100000,
-			0b000001000000000000000,
-			0b000000101001000000100,
-			0b000000100101000001000,
-			0b000000010100001000001,
-			0b000000001010000000010,
-			0b000000000000010000000,
-			0b001001011010100100000,
-			0b000000011000000000000,
-			0b000000011001010100000,		// pp
-		};
-
-		pla->SetMatrix(bitmask);
+		static const bool precalc_done = PreCalcMask();
+		(void)precalc_done;
 	}
 
 	Decoder::~Decoder()
 	{
-		delete pla;
 	}
 
 	void Decoder::sim(size_t input_bits, TriState** outputs)
 	{
-		pla->sim(input_bits, outputs);
+		for (size_t out = 0; out < outputs_count; out++)
+		{
+			// Since the decoder lines are multi-input NORs - the default output is `1`.
+			decoder_out[out] = (input_bits & decoder_terms.inputs[out]) != 0 ? TriState::Zero : TriState::One;
+		}
+		*outputs = decoder_out;
+	}
+
+	DecoderMask Decoder::ir_tab[0x100];
+	DecoderMask Decoder::tx_tab[0x40];
+
+	bool Decoder::PreCalcMask()
+	{
+		// The NOR of a term is the AND of the NOR of its IR inputs and the NOR of its T-counter inputs, so the two halves are tabulated separately.
+
+		for (size_t ir = 0; ir < 0x100; ir++)
+		{
+			DecoderInput decoder_in{};
+			decoder_in.packed_bits = 0;
+
+			TriState IR0 = ir & 0b00000001 ? TriState::One : TriState::Zero;
+			TriState IR1 = ir & 0b00000010 ? TriState::One : TriState::Zero;
+			TriState IR2 = ir & 0b00000100 ? TriState::One : TriState::Zero;
+			TriState IR3 = ir & 0b00001000 ? TriState::One : TriState::Zero;
+			TriState IR4 = ir & 0b00010000 ? TriState::One : TriState::Zero;
+			TriState IR5 = ir & 0b00100000 ? TriState::One : TriState::Zero;
+			TriState IR6 = ir & 0b01000000 ? TriState::One : TriState::Zero;
+			TriState IR7 = ir & 0b10000000 ? TriState::One : TriState::Zero;
+
+			decoder_in.n_IR0 = NOT(IR0);
+			decoder_in.n_IR1 = NOT(IR1);
+			decoder_in.IR01 = OR(IR0, IR1);
+			decoder_in.n_IR2 = NOT(IR2);
+			decoder_in.IR2 = IR2;
+			decoder_in.n_IR3 = NOT(IR3);
+			decoder_in.IR3 = IR3;
+			decoder_in.n_IR4 = NOT(IR4);
+			decoder_in.IR4 = IR4;
+			decoder_in.n_IR5 = NOT(IR5);
+			decoder_in.IR5 = IR5;
+			decoder_in.n_IR6 = NOT(IR6);
+			decoder_in.IR6 = IR6;
+			decoder_in.n_IR7 = NOT(IR7);
+			decoder_in.IR7 = IR7;
+
+			ir_tab[ir] = MakeMask(decoder_in.packed_bits);
+		}
+
+		for (size_t tx = 0; tx < 0x40; tx++)
+		{
+			DecoderInput decoder_in{};
+			decoder_in.packed_bits = 0;
+
+			decoder_in.n_T0 = tx & 1;
+			decoder_in.n_T1X = (tx >> 1) & 1;
+			decoder_in.n_T2 = (tx >> 2) & 1;
+			decoder_in.n_T3 = (tx >> 3) & 1;
+			decoder_in.n_T4 = (tx >> 4) & 1;
+			decoder_in.n_T5 = (tx >> 5) & 1;
+
+			tx_tab[tx] = MakeMask(decoder_in.packed_bits);
+		}
+
+		return true;
+	}
+
+	DecoderMask Decoder::MakeMask(size_t input_bits)
+	{
+		DecoderMask mask{};
+		for (size_t out = 0; out < outputs_count; out++)
+		{
+			if ((input_bits & decoder_terms.inputs[out]) == 0)
+			{
+				mask.w[out >> 6] |= 1ULL << (out & 63);
+			}
+		}
+		return mask;
 	}
 
+	// Groups of decoder lines that go to the multi-input NOR gates of the random logic and the dispatcher.
+
+	static constexpr DecoderMask SB_X_Lines = DecoderRange(14, 16);
+	static constexpr DecoderMask SB_Y_Lines = DecoderRange(18, 20);
+	static constexpr DecoderMask STKOP_Lines = DecoderRange(21, 26);
+	static constexpr DecoderMask SB_ADD_Lines = DecoderOut(30) | DecoderOut(31) | DecoderOut(45) | DecoderOut(47) | DecoderOut(48);
+	static constexpr DecoderMask INC_SB_Lines = DecoderRange(39, 43);
+	static constexpr DecoderMask DL_DB_Lines = DecoderRange(45, 48);
+	static constexpr DecoderMask SB_AC_Lines = DecoderRange(58, 64);
+	static constexpr DecoderMask AC_SB_Lines = DecoderRange(66, 68);
+	static constexpr DecoderMask AND_Lines = DecoderRange(69, 70);
+	static constexpr DecoderMask PGX_Lines = DecoderRange(71, 72);
+	static constexpr DecoderMask PCH_DB_Lines = DecoderRange(77, 78);
+	static constexpr DecoderMask DL_ADL_Lines = DecoderRange(81, 82);
+	static constexpr DecoderMask NOADL_Lines = DecoderOut(26) | DecoderRange(84, 89);
+	static constexpr DecoderMask IND_Lines = DecoderOut(84) | DecoderOut(89) | DecoderOut(91);
+	static constexpr DecoderMask TRESX_Lines = DecoderRange(91, 92);
+	static constexpr DecoderMask JB_Lines = DecoderRange(94, 96);
+	static constexpr DecoderMask WR_Lines = DecoderOut(98) | DecoderOut(100);
+	static constexpr DecoderMask ENDX_Lines = DecoderRange(100, 105);
+	static constexpr DecoderMask SHIFT_Lines = DecoderRange(106, 107);
+	static constexpr DecoderMask MemOp_Lines = DecoderOut(111) | DecoderRange(122, 125);
+
 	void IR::sim()
 	{
 		if (core->wire.PHI1 && core->wire.FETCH)
@@ -202,12 +333,22 @@ namespace M6502Core
 		}
 	}
 
+	TriState PreDecode::precalc_n_TWOCYCLE[0x100];
+	TriState PreDecode::precalc_n_IMPLIED[0x100];
+
 	PreDecode::PreDecode(M6502* parent)
 	{
 		core = parent;
 
-		// Pre-calculate the values for n_TWOCYCLE / n_IMPLIED
+		static const bool precalc_done = PreCalc();
+		(void)precalc_done;
+	}
 
+	/// <summary>
+	/// Pre-calculate the values for n_TWOCYCLE / n_IMPLIED
+	/// </summary>
+	bool PreDecode::PreCalc()
+	{
 		for (size_t pd = 0; pd < 0x100; pd++)
 		{
 			TriState PD0 = pd & 0b00000001 ? TriState::One : TriState::Zero;
@@ -241,6 +382,8 @@ namespace M6502Core
 			precalc_n_TWOCYCLE[pd] = AND(NAND(IMPLIED, NOT(res2)), NOR(res3, res4));
 			precalc_n_IMPLIED[pd] = NOT(IMPLIED);
 		}
+
+		return true;
 	}
 
 	void PreDecode::sim(uint8_t* data_bus)
@@ -354,7 +497,7 @@ namespace M6502Core
 	{
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
-		TriState BRK5 = core->decoder_out[22];
+		TriState BRK5 = core->decoder_mask.out(22);
 		TriState n_ready = core->wire.n_ready;
 		TriState RESP = core->wire.RESP;
 		TriState n_NMIP = core->wire.n_NMIP;
@@ -414,7 +557,7 @@ namespace M6502Core
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState T0 = core->wire.T0;
-		TriState BR2 = core->decoder_out[80];
+		TriState BR2 = core->decoder_mask.out(80);
 		TriState n_I_OUT = core->random->flags->getn_I_OUT(core->wire.BRK6E);
 		TriState n_IRQP = core->wire.n_IRQP;
 		TriState n_DONMI = core->wire.n_DONMI;
@@ -455,6 +598,12 @@ namespace M6502Core
 
 	void Flags::sim_Load()
 	{
+		if (HLE)
+		{
+			sim_LoadHLE();
+			return;
+		}
+
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState SO = core->wire.SO;
@@ -588,6 +737,12 @@ namespace M6502Core
 
 	void Flags::sim_Store()
 	{
+		if (HLE)
+		{
+			sim_StoreHLE();
+			return;
+		}
+
 		if (core->cmd.P_DB)
 		{
 			core->DB &= 0b00100000;
@@ -614,68 +769,233 @@ namespace M6502Core
 
 	BaseLogic::TriState Flags::getn_Z_OUT()
 	{
+		if (HLE)
+		{
+			return (latch1 & Z_FLAG) ? TriState::Zero : TriState::One;
+		}
 		return z_latch1.nget();
 	}
 
 	BaseLogic::TriState Flags::getn_N_OUT()
 	{
+		if (HLE)
+		{
+			return (latch1 & N_FLAG) ? TriState::Zero : TriState::One;
+		}
 		return n_latch1.nget();
 	}
 
 	BaseLogic::TriState Flags::getn_C_OUT()
 	{
+		if (HLE)
+		{
+			return (latch1 & C_FLAG) ? TriState::Zero : TriState::One;
+		}
 		return c_latch1.nget();
 	}
 
 	BaseLogic::TriState Flags::getn_D_OUT()
 	{
+		if (HLE)
+		{
+			return (latch1 & D_FLAG) ? TriState::Zero : TriState::One;
+		}
 		return d_latch1.nget();
 	}
 
 	BaseLogic::TriState Flags::getn_I_OUT(TriState BRK6E)
 	{
+		if (HLE)
+		{
+			return ((latch1 & I_FLAG) || BRK6E == TriState::One) ? TriState::Zero : TriState::One;
+		}
 		return AND(i_latch1.nget(), NOT(BRK6E));
 	}
 
 	BaseLogic::TriState Flags::getn_V_OUT()
 	{
+		if (HLE)
+		{
+			return (latch1 & V_FLAG) ? TriState::Zero : TriState::One;
+		}
 		return v_latch1.nget();
 	}
 
+	// The second latch of the flag holds the value during the next PHI1, so both latches are set.
+
 	void Flags::set_Z_OUT(TriState val)
 	{
+		if (HLE)
+		{
+			set_HLE(Z_FLAG, val);
+			return;
+		}
 		z_latch1.set(val, TriState::One);
+		z_latch2.set(NOT(val), TriState::One);
 	}
 
 	void Flags::set_N_OUT(TriState val)
 	{
+		if (HLE)
+		{
+			set_HLE(N_FLAG, val);
+			return;
+		}
 		n_latch1.set(val, TriState::One);
+		n_latch2.set(NOT(val), TriState::One);
 	}
 
 	void Flags::set_C_OUT(TriState val)
 	{
+		if (HLE)
+		{
+			set_HLE(C_FLAG, val);
+			return;
+		}
 		c_latch1.set(val, TriState::One);
+		c_latch2.set(NOT(val), TriState::One);
 	}
 
 	void Flags::set_D_OUT(TriState val)
 	{
+		if (HLE)
+		{
+			set_HLE(D_FLAG, val);
+			return;
+		}
 		d_latch1.set(val, TriState::One);
+		d_latch2.set(NOT(val), TriState::One);
 	}
 
 	void Flags::set_I_OUT(TriState val)
 	{
+		if (HLE)
+		{
+			set_HLE(I_FLAG, val);
+			return;
+		}
 		i_latch1.set(val, TriState::One);
+		i_latch2.set(NOT(val), TriState::One);
 	}
 
 	void Flags::set_V_OUT(TriState val)
 	{
+		if (HLE)
+		{
+			set_HLE(V_FLAG, val);
+			return;
+		}
 		v_latch1.set(val, TriState::One);
+		v_latch2.set(NOT(val), TriState::One);
+	}
+
+	void Flags::set_HLE(uint8_t flag, TriState val)
+	{
+		if (val == TriState::One)
+		{
+			latch1 |= flag;
+			latch2 &= ~flag;
+		}
+		else
+		{
+			latch1 &= ~flag;
+			latch2 |= flag;
+		}
+	}
+
+	void Flags::sim_LoadHLE()
+	{
+		TriState PHI1 = core->wire.PHI1;
+		TriState PHI2 = core->wire.PHI2;
+		TriState SO = core->wire.SO;
+		TriState AVR_V = core->cmd.AVR_V ? TriState::One : TriState::Zero;
+
+		// The SO edge detector and the AVR latch are the same as in sim_Load.
+
+		avr_latch.set(AVR_V, PHI2);
+		so_latch1.set(NOT(SO), PHI1);
+		so_latch2.set(so_latch1.nget(), PHI2);
+		so_latch3.set(so_latch2.nget(), PHI1);
+		vset_latch.set(NOR(so_latch1.nget(), so_latch3.get()), PHI2);
+
+		if (PHI1 == TriState::Zero)
+		{
+			// The second latch holds the inverted flag (the I flag is also cleared by BRK6E).
+
+			latch2 = ~latch1 & ALL_FLAGS;
+			if (core->wire.BRK6E == TriState::One)
+			{
+				latch2 &= ~I_FLAG;
+			}
+			return;
+		}
+
+		uint8_t DB = core->DB;
+		bool IR5 = core->wire.n_IR5 == TriState::Zero;
+		bool ACR = core->alu->getACR() == TriState::One;
+		bool AVR = core->alu->getAVR() == TriState::One;
+		bool avr = avr_latch.get() == TriState::One;
+		bool vset = vset_latch.get() == TriState::One;
+
+		// Flags loaded from DB (DB_P: Z, I, D; the rest have their own commands)
+
+		uint8_t from_db = 0;
+		from_db |= core->cmd.DB_P ? (Z_FLAG | I_FLAG | D_FLAG) : 0;
+		from_db |= core->cmd.DB_N ? N_FLAG : 0;
+		from_db |= core->cmd.DB_C ? C_FLAG : 0;
+		from_db |= core->cmd.DB_V ? V_FLAG : 0;
+
+		// Flags which keep their value
+
+		uint8_t loaded = from_db;
+		loaded |= core->cmd.DBZ_Z ? Z_FLAG : 0;
+		loaded |= (core->cmd.IR5_C || core->cmd.ACR_C) ? C_FLAG : 0;
+		loaded |= core->cmd.IR5_D ? D_FLAG : 0;
+		loaded |= core->cmd.IR5_I ? I_FLAG : 0;
+		loaded |= (avr || vset) ? V_FLAG : 0;
+
+		// The terms that ground the first latch (the flag is 0)
+
+		uint8_t clear = (~DB & from_db) | (latch2 & ~loaded);
+		clear |= (core->cmd.DBZ_Z && DB != 0) ? Z_FLAG : 0;
+		clear |= (core->cmd.IR5_C && !IR5) ? C_FLAG : 0;
+		clear |= (core->cmd.ACR_C && !ACR) ? C_FLAG : 0;
+		clear |= (core->cmd.IR5_D && !IR5) ? D_FLAG : 0;
+		clear |= (core->cmd.IR5_I && !IR5) ? I_FLAG : 0;
+		clear |= ((avr && !AVR) || core->cmd.Z_V) ? V_FLAG : 0;
+
+		latch1 = ~clear & ALL_FLAGS;
+	}
+
+	void Flags::sim_StoreHLE()
+	{
+		if (core->cmd.P_DB)
+		{
+			TriState BRK6E = core->wire.BRK6E;
+
+			core->DB &= 0b00100000;
+			core->DB |= latch1;
+			core->DB |= BRK6E == TriState::One ? I_FLAG : 0;
+			core->DB |= core->brk->getB_OUT(BRK6E) << 4;
+
+			core->DB_Dirty = true;
+		}
 	}
 
+	RegsControl_TempWire RegsControl::temp_tab[0x10000];
+
 	RegsControl::RegsControl(M6502* parent)
 	{
 		core = parent;
 
+		static const bool precalc_done = PreCalcTable(core->decoder);
+		(void)precalc_done;
+
+		prev_temp.bits = 0xff;
+	}
+
+	bool RegsControl::PreCalcTable(Decoder* decoder)
+	{
 		size_t maxVal = 1ULL << 16;
 		for (size_t n = 0; n < maxVal; n++)
 		{
@@ -689,15 +1009,15 @@ namespace M6502Core
 			bool n_ready = (n >> 14) & 1;
 			bool n_ready_latch = (n >> 15) & 1;
 
-			temp_tab[n] = PreCalc(ir, n_T0, n_T1X, n_T2, n_T3, n_T4, n_T5, n_ready, n_ready_latch);
+			temp_tab[n] = PreCalc(decoder, ir, n_T0, n_T1X, n_T2, n_T3, n_T4, n_T5, n_ready, n_ready_latch);
 		}
 
-		prev_temp.bits = 0xff;
+		return true;
 	}
 
 	void RegsControl::sim()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState n_ready = core->wire.n_ready;
@@ -730,7 +1050,7 @@ namespace M6502Core
 				prev_temp.bits = temp.bits;
 			}
 
-			ssb_latch.set(NOT(d[17]), PHI2);
+			ssb_latch.set(NOT(d.out(17)), PHI2);
 		}
 
 		// Outputs
@@ -758,7 +1078,7 @@ namespace M6502Core
 		core->cmd.S_ADL = sadl_latch.nget();
 	}
 
-	RegsControl_TempWire RegsControl::PreCalc(uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5, bool n_ready, bool n_ready_latch)
+	RegsControl_TempWire RegsControl::PreCalc(Decoder* decoder, uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5, bool n_ready, bool n_ready_latch)
 	{
 		TriState* d;
 		DecoderInput decoder_in{};
@@ -798,7 +1118,7 @@ namespace M6502Core
 		decoder_in.n_T4 = n_T4;
 		decoder_in.n_T5 = n_T5;
 
-		core->decoder->sim(decoder_in.packed_bits, &d);
+		decoder->sim(decoder_in.packed_bits, &d);
 
 		// Wires
 
@@ -854,10 +1174,20 @@ namespace M6502Core
 		return temp;
 	}
 
+	CarryBCD_TempWire ALUControl::temp_tab1[1 << 19];
+
 	ALUControl::ALUControl(M6502* parent)
 	{
 		core = parent;
 
+		static const bool precalc_done = PreCalcTable1(core->decoder);
+		(void)precalc_done;
+
+		prev_temp1.bits = 0xff;
+	}
+
+	bool ALUControl::PreCalcTable1(Decoder* decoder)
+	{
 		size_t maxVal = 1ULL << 19;
 		for (size_t n = 0; n < maxVal; n++)
 		{
@@ -874,16 +1204,16 @@ namespace M6502Core
 			bool BRFW = (n >> 17) & 1;
 			bool n_C_OUT = (n >> 18) & 1;
 
-			temp_tab1[n] = PreCalc1(ir, n_T0, n_T1X, n_T2, n_T3, n_T4, n_T5,
+			temp_tab1[n] = PreCalc1(decoder, ir, n_T0, n_T1X, n_T2, n_T3, n_T4, n_T5,
 				n_ready, T0, RMW_T6, BRFW, n_C_OUT);
 		}
 
-		prev_temp1.bits = 0xff;
+		return true;
 	}
 
 	void ALUControl::sim()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState n_ready = core->wire.n_ready;
@@ -894,14 +1224,7 @@ namespace M6502Core
 
 		if (PHI2)
 		{
-			TriState n3[6];
-			n3[0] = d[21];
-			n3[1] = d[22];
-			n3[2] = d[23];
-			n3[3] = d[24];
-			n3[4] = d[25];
-			n3[5] = d[26];
-			STKOP = NOR(nready_latch.get(), NOR6(n3));
+			STKOP = NOR(nready_latch.get(), d.nor(STKOP_Lines));
 		}
 
 		sim_CarryBCD();
@@ -912,8 +1235,8 @@ namespace M6502Core
 
 		// ADD/SB7
 
-		TriState SR = NOT(NOR(d[75], AND(d[76], RMW_T6)));
-		TriState n_ROR = NOT(d[27]);
+		TriState SR = NOT(NOR(d.out(75), AND(d.out(76), RMW_T6)));
+		TriState n_ROR = NOT(d.out(27));
 		cout_latch.set(NOT(n_C_OUT), PHI2);
 		mux_latch1.set(NOR(nready_latch.get(), NOT(SR)), PHI2);
 		sr_latch1.set(SR, PHI2);
@@ -960,7 +1283,7 @@ namespace M6502Core
 
 	void ALUControl::sim_CarryBCD()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState n_ready = core->wire.n_ready;
@@ -970,7 +1293,7 @@ namespace M6502Core
 		TriState n_C_OUT = core->random->flags->getn_C_OUT();
 		TriState n_D_OUT = core->random->flags->getn_D_OUT();
 
-		TriState SBC0 = d[51];
+		TriState SBC0 = d.out(51);
 
 		// Additional signals (/ACIN, /DAA, /DSA)
 
@@ -1014,7 +1337,7 @@ namespace M6502Core
 		}
 
 		TriState D_OUT = NOT(n_D_OUT);
-		daa_latch1.set(NOT(NOR(NAND(d[52], D_OUT), SBC0)), PHI2);
+		daa_latch1.set(NOT(NOR(NAND(d.out(52), D_OUT), SBC0)), PHI2);
 		daa_latch2.set(daa_latch1.nget(), PHI1);
 
 		dsa_latch1.set(NAND(SBC0, D_OUT), PHI2);
@@ -1023,15 +1346,13 @@ namespace M6502Core
 
 	void ALUControl::sim_ALUInput()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI2 = core->wire.PHI2;
 		TriState n_ready = core->wire.n_ready;
 		TriState BRK6E = core->wire.BRK6E;
 
-		TriState SBC0 = d[51];
-		TriState JSR_5 = d[56];
-		TriState JSR2 = d[48];
-		TriState RET = d[47];
+		TriState SBC0 = d.out(51);
+		TriState JSR_5 = d.out(56);
 
 		// Setting the ALU input values (NDB/ADD, DB/ADD, 0/ADD, SB/ADD, ADL/ADD)
 
@@ -1042,17 +1363,13 @@ namespace M6502Core
 			dbadd_latch.set(NAND(n_NDB_ADD, n_ADL_ADD), PHI2);
 			adladd_latch.set(n_ADL_ADD, PHI2);
 
-			TriState sbadd[9]{};
+			TriState sbadd[5]{};
 			sbadd[0] = STKOP;
-			sbadd[1] = d[30];
-			sbadd[2] = d[31];
-			sbadd[3] = d[45];
-			sbadd[4] = JSR2;
-			sbadd[5] = INC_SB;
-			sbadd[6] = RET;
-			sbadd[7] = BRK6E;
-			sbadd[8] = n_ready;
-			TriState SB_ADD = NOR9(sbadd);
+			sbadd[1] = d.any(SB_ADD_Lines);		// JSR2, RET and others
+			sbadd[2] = INC_SB;
+			sbadd[3] = BRK6E;
+			sbadd[4] = n_ready;
+			TriState SB_ADD = NOR5(sbadd);
 			sbadd_latch.set(NOT(SB_ADD), PHI2);
 			zadd_latch.set(SB_ADD, PHI2);
 		}
@@ -1060,16 +1377,16 @@ namespace M6502Core
 
 	void ALUControl::sim_ALUOps()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState n_ready = core->wire.n_ready;
 		TriState RMW_T6 = core->wire.RMW_T6;
 
-		TriState EOR = d[29];
-		TriState _OR = NOT(NOR(d[32], n_ready));
-		TriState _AND = NOT(NOR(d[69], d[70]));
-		TriState SR = NOT(NOR(d[75], AND(d[76], RMW_T6)));
+		TriState EOR = d.out(29);
+		TriState _OR = NOT(NOR(d.out(32), n_ready));
+		TriState _AND = d.any(AND_Lines);
+		TriState SR = NOT(NOR(d.out(75), AND(d.out(76), RMW_T6)));
 
 		// ALU operation commands (ANDS, EORS, ORS, SRS, SUMS)
 
@@ -1100,17 +1417,15 @@ namespace M6502Core
 
 	void ALUControl::sim_ADDOut()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI2 = core->wire.PHI2;
 		TriState T1 = core->disp->getT1();
 		TriState RMW_T7 = core->wire.RMW_T7;
 
-		TriState RTS_5 = d[84];
-		TriState RTI_5 = d[26];
-		TriState JSR_5 = d[56];
+		TriState JSR_5 = d.out(56);
 
-		TriState BR0 = AND(d[73], NOT(core->wire.n_PRDY));
-		TriState PGX = NAND(NOR(d[71], d[72]), NOT(BR0));
+		TriState BR0 = AND(d.out(73), NOT(core->wire.n_PRDY));
+		TriState PGX = NAND(d.nor(PGX_Lines), NOT(BR0));
 
 		// Control commands of the intermediate ALU result (ADD/SB06, ADD/SB7, ADD/ADL)
 
@@ -1127,20 +1442,12 @@ namespace M6502Core
 
 			addsb7_latch.set(NOR(n_ADD_SB06, n_ADD_SB7), PHI2);
 
-			TriState noadl[7]{};
-			noadl[0] = RTS_5;
-			noadl[1] = d[85];
-			noadl[2] = d[86];
-			noadl[3] = d[87];
-			noadl[4] = d[88];
-			noadl[5] = d[89];
-			noadl[6] = RTI_5;
-			TriState NOADL = NOR7(noadl);
+			TriState NOADL = d.nor(NOADL_Lines);		// RTS/5, RTI/5 and others
 			addadl_latch.set(NOT(NOR(NOADL, PGX)), PHI2);
 		}
 	}
 
-	CarryBCD_TempWire ALUControl::PreCalc1(uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5,
+	CarryBCD_TempWire ALUControl::PreCalc1(Decoder* decoder, uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5,
 		bool n_ready, bool T0, bool RMW_T6, bool BRFW, bool n_C_OUT)
 	{
 		TriState* d;
@@ -1181,7 +1488,7 @@ namespace M6502Core
 		decoder_in.n_T4 = n_T4;
 		decoder_in.n_T5 = n_T5;
 
-		core->decoder->sim(decoder_in.packed_bits, &d);
+		decoder->sim(decoder_in.packed_bits, &d);
 
 		// Wires
 
@@ -1218,40 +1525,33 @@ namespace M6502Core
 
 	void BusControl::sim()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI2 = core->wire.PHI2;
 
 		if (PHI2 == TriState::One)
 		{
-			TriState BR0 = AND(d[73], NOT(core->wire.n_PRDY));
-			TriState _AND = NOT(NOR(d[69], d[70]));
+			TriState BR0 = AND(d.out(73), NOT(core->wire.n_PRDY));
+			TriState _AND = d.any(AND_Lines);
 			TriState RMW_T7 = core->wire.RMW_T7;
 
-			TriState n_SB_X = NOR3(d[14], d[15], d[16]);
-			TriState n_SB_Y = NOR3(d[18], d[19], d[20]);
+			TriState n_SB_X = d.nor(SB_X_Lines);
+			TriState n_SB_Y = d.nor(SB_Y_Lines);
 			TriState n_SBXY = NAND(n_SB_X, n_SB_Y);
 
-			TriState PGX = NAND(NOR(d[71], d[72]), NOT(BR0));
+			TriState PGX = NAND(d.nor(PGX_Lines), NOT(BR0));
 
 			TriState PHI1 = core->wire.PHI1;
 			TriState STOR = core->disp->getSTOR(d);
-			TriState STXY = NOR(AND(STOR, d[0]), AND(STOR, d[12]));
+			TriState STXY = NOR(AND(STOR, d.out(0)), AND(STOR, d.out(12)));
 			TriState Z_ADL0 = core->cmd.Z_ADL0 ? TriState::One : TriState::Zero;
 			TriState ACRL2 = core->wire.ACRL2;
 
-			TriState JB = NOR3(d[94], d[95], d[96]);
+			TriState JB = d.nor(JB_Lines);
 			TriState DL_PCH = NOR(NOT(core->wire.T0), JB);
 
 			TriState n_ready = core->wire.n_ready;
 
-			TriState incsb[6]{};
-			incsb[0] = d[39];
-			incsb[1] = d[40];
-			incsb[2] = d[41];
-			incsb[3] = d[42];
-			incsb[4] = d[43];
-			incsb[5] = AND(core->wire.RMW_T6, d[44]);
-			TriState INC_SB = NOT(NOR6(incsb));
+			TriState INC_SB = OR(d.any(INC_SB_Lines), AND(core->wire.RMW_T6, d.out(44)));
 
 			TriState BRK6E = core->wire.BRK6E;
 			TriState T0 = core->wire.T0;
@@ -1259,27 +1559,22 @@ namespace M6502Core
 			TriState RMW_T6 = core->wire.RMW_T6;
 			TriState IR0 = core->ir->IROut & 1 ? TriState::One : TriState::Zero;
 
-			TriState n_DL_ADL = NOR(d[81], d[82]);
-			TriState RTS_5 = d[84];
-			TriState BR2 = d[80];
-			TriState BR3 = d[93];
-			TriState T2 = d[28];
-			TriState JSR2 = d[48];
-			TriState JSR_5 = d[56];
-			TriState JMP_4 = d[101];
-			TriState pp = d[129];
+			TriState n_DL_ADL = d.nor(DL_ADL_Lines);
+			TriState RTS_5 = d.out(84);
+			TriState BR2 = d.out(80);
+			TriState BR3 = d.out(93);
+			TriState T2 = d.out(28);
+			TriState JSR2 = d.out(48);
+			TriState JSR_5 = d.out(56);
+			TriState JMP_4 = d.out(101);
+			TriState pp = d.out(129);
 			TriState JSXY = NAND(NOT(JSR2), STXY);
 
-			TriState ind[4]{};
-			ind[0] = d[89];
-			ind[1] = AND(d[90], NOT(pp));
-			ind[2] = d[91];
-			ind[3] = RTS_5;
-			TriState IND = NOT(NOR4(ind));
+			TriState IND = OR(d.any(IND_Lines), AND(d.out(90), NOT(pp)));		// RTS/5 and others
 
-			TriState IMPLIED = AND(d[128], NOT(pp));
+			TriState IMPLIED = AND(d.out(128), NOT(pp));
 			IMPLIED = AND(IMPLIED, NOT(IR0));
-			TriState ABS_2 = AND(d[83], NOT(pp));
+			TriState ABS_2 = AND(d.out(83), NOT(pp));
 			TriState imp_abs = NOR(NOR(ABS_2, T0), IMPLIED);
 
 			TriState nap[6]{};
@@ -1298,7 +1593,7 @@ namespace M6502Core
 
 			// External address bus control
 
-			TriState n_ADL_ABL = NAND(NOR(RMW_T6, RMW_T7), NOR(NOT(NOR(d[71], d[72])), n_ready));
+			TriState n_ADL_ABL = NAND(NOR(RMW_T6, RMW_T7), NOR(d.any(PGX_Lines), n_ready));
 			adl_abl_latch.set(n_ADL_ABL, PHI2);
 
 			TriState n1[4];
@@ -1311,32 +1606,18 @@ namespace M6502Core
 
 			// ALU connection to SB, DB buses (AC/DB, SB/AC, AC/SB)
 
-			TriState sbac[7]{};
-			sbac[0] = d[58];
-			sbac[1] = d[59];
-			sbac[2] = d[60];
-			sbac[3] = d[61];
-			sbac[4] = d[62];
-			sbac[5] = d[63];
-			sbac[6] = d[64];
-			TriState n_SB_AC = NOR7(sbac);
+			TriState n_SB_AC = d.nor(SB_AC_Lines);
 			sb_ac_latch.set(n_SB_AC, PHI2);
 
-			TriState acsb[5]{};
-			acsb[0] = AND(NOT(d[64]), d[65]);
-			acsb[1] = d[66];
-			acsb[2] = d[67];
-			acsb[3] = d[68];
-			acsb[4] = _AND;
-			TriState n_AC_SB = NOR5(acsb);
+			TriState n_AC_SB = NOR3(AND(NOT(d.out(64)), d.out(65)), d.any(AC_SB_Lines), _AND);
 			ac_sb_latch.set(n_AC_SB, PHI2);
 
-			ac_db_latch.set(NOR(d[74], AND(d[79], STOR)), PHI2);
+			ac_db_latch.set(NOR(d.out(74), AND(d.out(79), STOR)), PHI2);
 
 			// Control of the SB, DB and ADH internal buses (SB/DB, SB/ADH, 0/ADH0, 0/ADH17)
 
 			z_adh0_latch.set(n_DL_ADL, PHI2);
-			z_adh17_latch.set(NOR(d[57], NOT(n_DL_ADL)), PHI2);
+			z_adh17_latch.set(NOR(d.out(57), NOT(n_DL_ADL)), PHI2);
 
 			TriState ztst[4]{};
 			ztst[0] = n_SBXY;
@@ -1346,9 +1627,9 @@ namespace M6502Core
 			TriState n_ZTST = NOR4(ztst);
 
 			TriState sbdb[6]{};
-			sbdb[0] = NOT(NAND(RMW_T6, d[55]));
+			sbdb[0] = NOT(NAND(RMW_T6, d.out(55)));
 			sbdb[1] = NOR(n_ZTST, _AND);
-			sbdb[2] = d[67];
+			sbdb[2] = d.out(67);
 			sbdb[3] = T1;
 			sbdb[4] = BR2;
 			sbdb[5] = JSXY;
@@ -1362,18 +1643,12 @@ namespace M6502Core
 			dl_adh_latch.set(NOR(DL_PCH, IND), PHI2);
 			dl_adl_latch.set(n_DL_ADL, PHI2);
 
-			TriState n2[6]{};
-			n2[0] = INC_SB;
-			n2[1] = d[45];
-			n2[2] = BRK6E;
-			n2[3] = d[46];
-			n2[4] = d[47];
-			n2[5] = JSR2;
+			TriState n2 = NOR3(INC_SB, BRK6E, d.any(DL_DB_Lines));		// RET, JSR2 and others
 
 			TriState n3[5]{};
 			n3[0] = BR2;
 			n3[1] = imp_abs;
-			n3[2] = NOT(NOR6(n2));
+			n3[2] = NOT(n2);
 			n3[3] = JMP_4;
 			n3[4] = RMW_T6;
 			TriState n_DL_DB = NOR5(n3);
@@ -1401,7 +1676,7 @@ namespace M6502Core
 
 	void PC_Control::sim()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState n_ready = core->wire.n_ready;
@@ -1415,20 +1690,20 @@ namespace M6502Core
 		{
 			TriState T0 = core->wire.T0;
 			TriState T1 = core->disp->getT1();
-			TriState BR0 = AND(d[73], NOT(core->wire.n_PRDY));
+			TriState BR0 = AND(d.out(73), NOT(core->wire.n_PRDY));
 
-			TriState JSR_5 = d[56];
-			TriState RTS_5 = d[84];
-			TriState pp = d[129];
-			TriState BR2 = d[80];
-			TriState BR3 = d[93];
+			TriState JSR_5 = d.out(56);
+			TriState RTS_5 = d.out(84);
+			TriState pp = d.out(129);
+			TriState BR2 = d.out(80);
+			TriState BR3 = d.out(93);
 
-			TriState ABS_2 = AND(d[83], NOT(pp));
-			TriState JB = NOR3(d[94], d[95], d[96]);
+			TriState ABS_2 = AND(d.out(83), NOT(pp));
+			TriState JB = d.nor(JB_Lines);
 
 			// DB
 
-			TriState n_PCH_DB = NOR(d[77], d[78]);
+			TriState n_PCH_DB = d.nor(PCH_DB_Lines);
 			pch_db_latch1.set(n_PCH_DB, PHI2);
 			TriState n_PCL_DB = pcl_db_latch1.nget();
 			PC_DB = NAND(n_PCL_DB, n_PCH_DB);
@@ -1573,20 +1848,14 @@ namespace M6502Core
 
 	void Dispatcher::sim_BeforeRandomLogic()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState n_ready = core->wire.n_ready;
 
-		TriState n_SHIFT = NOR(d[106], d[107]);
+		TriState n_SHIFT = d.nor(SHIFT_Lines);
 
-		TriState memop_in[5]{};
-		memop_in[0] = d[111];
-		memop_in[1] = d[122];
-		memop_in[2] = d[123];
-		memop_in[3] = d[124];
-		memop_in[4] = d[125];
-		TriState n_MemOp = NOR5(memop_in);
+		TriState n_MemOp = d.nor(MemOp_Lines);
 
 		// T6 / T7 (RMW)
 
@@ -1604,7 +1873,7 @@ namespace M6502Core
 
 	void Dispatcher::sim_AfterRandomLogic()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState BRK6E = core->wire.BRK6E;
@@ -1626,12 +1895,12 @@ namespace M6502Core
 		TriState RDY = core->wire.RDY;
 		TriState DORES = core->wire.DORES;
 
-		TriState BR2 = d[80];
-		TriState BR3 = d[93];
+		TriState BR2 = d.out(80);
+		TriState BR3 = d.out(93);
 
-		TriState n_SHIFT = NOR(d[106], d[107]);
+		TriState n_SHIFT = d.nor(SHIFT_Lines);
 
-		TriState n_STORE = NOT(d[97]);
+		TriState n_STORE = NOT(d.out(97));
 		TriState REST = NAND(n_SHIFT, n_STORE);
 
 		// Ready Delay (get)
@@ -1664,33 +1933,19 @@ namespace M6502Core
 		ends_latch2.set(RESP, PHI2);
 		TriState TRES1 = NOT(n_TRES1);
 
-		tresx_latch1.set(NOR(d[91], d[92]), PHI2);
+		tresx_latch1.set(d.nor(TRESX_Lines), PHI2);
 
 		TriState ENDX;
 		TriState n_MemOp;
 
 		if (PHI2)
 		{
-			TriState memop_in[5]{};
-			memop_in[0] = d[111];
-			memop_in[1] = d[122];
-			memop_in[2] = d[123];
-			memop_in[3] = d[124];
-			memop_in[4] = d[125];
-			n_MemOp = NOR5(memop_in);
-
-			TriState endx_1[6]{};
-			endx_1[0] = d[100];
-			endx_1[1] = d[101];
-			endx_1[2] = d[102];
-			endx_1[3] = d[103];
-			endx_1[4] = d[104];
-			endx_1[5] = d[105];
+			n_MemOp = d.nor(MemOp_Lines);
 
 			TriState endx_2[4]{};
-			endx_2[0] = NOR3(d[96], NOT(n_SHIFT), n_MemOp);
+			endx_2[0] = NOR3(d.out(96), NOT(n_SHIFT), n_MemOp);
 			endx_2[1] = RMW_T7;
-			endx_2[2] = NOT(NOR6(endx_1));
+			endx_2[2] = d.any(ENDX_Lines);
 			endx_2[3] = BR3;
 
 			ENDX = NOR4(endx_2);
@@ -1720,14 +1975,13 @@ namespace M6502Core
 		{
 			TriState STOR = NOR(n_MemOp, n_STORE);
 
-			TriState wr_in[6]{};
+			TriState wr_in[5]{};
 			wr_in[0] = STOR;
 			wr_in[1] = PC_DB;
-			wr_in[2] = d[98];
-			wr_in[3] = d[100];
-			wr_in[4] = RMW_T6;
-			wr_in[5] = RMW_T7;
-			wr_latch.set(NOR6(wr_in), PHI2);
+			wr_in[2] = d.any(WR_Lines);
+			wr_in[3] = RMW_T6;
+			wr_in[4] = RMW_T7;
+			wr_latch.set(NOR5(wr_in), PHI2);
 		}
 
 		// Processor Readiness
@@ -1757,26 +2011,30 @@ namespace M6502Core
 		return t1_latch.nget();
 	}
 
-	TriState Dispatcher::getSTOR(TriState d[])
+	TriState Dispatcher::getSTOR(const DecoderMask& d)
 	{
-		TriState memop_in[5];
-		memop_in[0] = d[111];
-		memop_in[1] = d[122];
-		memop_in[2] = d[123];
-		memop_in[3] = d[124];
-		memop_in[4] = d[125];
-		TriState n_MemOp = NOR5(memop_in);
+		TriState n_MemOp = d.nor(MemOp_Lines);
 
-		TriState n_STORE = NOT(d[97]);
+		TriState n_STORE = NOT(d.out(97));
 		TriState STOR = NOR(n_MemOp, n_STORE);
 
 		return STOR;
 	}
 
+	FlagsControl_TempWire FlagsControl::temp_tab[0x10000];
+
 	FlagsControl::FlagsControl(M6502* parent)
 	{
 		core = parent;
 
+		static const bool precalc_done = PreCalcTable(core->decoder);
+		(void)precalc_done;
+
+		prev_temp.bits = 0xff;
+	}
+
+	bool FlagsControl::PreCalcTable(Decoder* decoder)
+	{
 		size_t maxVal = 1ULL << 16;
 		for (size_t n = 0; n < maxVal; n++)
 		{
@@ -1790,15 +2048,15 @@ namespace M6502Core
 			bool T5 = (n >> 14) & 1;
 			bool T6 = (n >> 15) & 1;
 
-			temp_tab[n] = PreCalc(ir, n_T0, n_T1X, n_T2, n_T3, n_T4, n_T5, T5, T6);
+			temp_tab[n] = PreCalc(decoder, ir, n_T0, n_T1X, n_T2, n_T3, n_T4, n_T5, T5, T6);
 		}
 
-		prev_temp.bits = 0xff;
+		return true;
 	}
 
 	void FlagsControl::sim()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI2 = core->wire.PHI2;
 		TriState n_ready = core->wire.n_ready;
 		TriState DB_P;
@@ -1826,15 +2084,15 @@ namespace M6502Core
 				prev_temp.bits = temp.bits;
 			}
 
-			iri_latch.set(NOT(d[108]), PHI2);
-			irc_latch.set(NOT(d[110]), PHI2);
-			ird_latch.set(NOT(d[120]), PHI2);
-			zv_latch.set(NOT(d[127]), PHI2);
-			dbz_latch.set(NOR3(acrc_latch.nget(), temp.ZTST ? TriState::One : TriState::Zero, d[109]), PHI2);
-			dbn_latch.set(d[109], PHI2);
+			iri_latch.set(NOT(d.out(108)), PHI2);
+			irc_latch.set(NOT(d.out(110)), PHI2);
+			ird_latch.set(NOT(d.out(120)), PHI2);
+			zv_latch.set(NOT(d.out(127)), PHI2);
+			dbz_latch.set(NOR3(acrc_latch.nget(), temp.ZTST ? TriState::One : TriState::Zero, d.out(109)), PHI2);
+			dbn_latch.set(d.out(109), PHI2);
 			DB_P = NOR(pin_latch.get(), n_ready);
 			dbc_latch.set(NOR(DB_P, temp.SR ? TriState::One : TriState::Zero), PHI2);
-			bit_latch.set(NOT(d[113]), PHI2);
+			bit_latch.set(NOT(d.out(113)), PHI2);
 		}
 		else
 		{
@@ -1847,7 +2105,7 @@ namespace M6502Core
 		core->cmd.IR5_I = iri_latch.nget();
 		core->cmd.IR5_C = irc_latch.nget();
 		core->cmd.IR5_D = ird_latch.nget();
-		core->cmd.AVR_V = d[112];
+		core->cmd.AVR_V = d.out(112);
 		core->cmd.Z_V = zv_latch.nget();
 		core->cmd.ACR_C = acrc_latch.nget();
 		core->cmd.DBZ_Z = dbz_latch.nget();
@@ -1857,7 +2115,7 @@ namespace M6502Core
 		core->cmd.DB_V = NAND(pin_latch.get(), bit_latch.get());
 	}
 
-	FlagsControl_TempWire FlagsControl::PreCalc(uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5, bool T5, bool T6)
+	FlagsControl_TempWire FlagsControl::PreCalc(Decoder* decoder, uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5, bool T5, bool T6)
 	{
 		TriState* d;
 		DecoderInput decoder_in{};
@@ -1897,7 +2155,7 @@ namespace M6502Core
 		decoder_in.n_T4 = n_T4;
 		decoder_in.n_T5 = n_T5;
 
-		core->decoder->sim(decoder_in.packed_bits, &d);
+		decoder->sim(decoder_in.packed_bits, &d);
 
 		// Wires
 
@@ -1944,7 +2202,7 @@ namespace M6502Core
 
 	void BranchLogic::sim()
 	{
-		TriState* d = core->decoder_out;
+		const DecoderMask& d = core->decoder_mask;
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState n_IR5 = core->wire.n_IR5;
@@ -1953,12 +2211,12 @@ namespace M6502Core
 		TriState n_N_OUT = core->random->flags->getn_N_OUT();
 		TriState n_Z_OUT = core->random->flags->getn_Z_OUT();
 		TriState DB7 = core->DB & 0x80 ? TriState::One : TriState::Zero;
-		TriState BR2 = d[80];
+		TriState BR2 = d.out(80);
 
 		// BRTAKEN
 
-		TriState n_IR6 = d[121];
-		TriState n_IR7 = d[126];
+		TriState n_IR6 = d.out(121);
+		TriState n_IR7 = d.out(126);
 
 		TriState res_C = NOR3(n_C_OUT, NOT(n_IR6), n_IR7);
 		TriState res_V = NOR3(n_V_OUT, n_IR6, NOT(n_IR7));
@@ -1997,7 +2255,7 @@ namespace M6502Core
 		pc_control = new PC_Control(core);
 		bus_control = new BusControl(core);
 		flags_control = new FlagsControl(core);
-		flags = new Flags(core);
+		flags = new Flags(core, core->HLE_Mode);
 		branch_logic = new BranchLogic(core);
 	}
 
@@ -2010,9 +2268,61 @@ namespace M6502Core
 		delete flags_control;
 		delete flags;
 		delete branch_logic;
+		SetCache(false, false);
 	}
 
 	void RandomLogic::sim()
+	{
+		if (cache == nullptr)
+		{
+			sim_Blocks();
+			return;
+		}
+
+		MakeKey(cache_key);
+
+		// FNV-1a over 64-bit words
+
+		uint64_t hash = 0xcbf29ce484222325ULL;
+		for (size_t i = 0; i < key_size; i += 8)
+		{
+			uint64_t word;
+			memcpy(&word, &cache_key[i], sizeof(word));
+			hash ^= word;
+			hash *= 0x100000001b3ULL;
+		}
+		hash ^= hash >> 32;
+
+		size_t index = hash & (CacheEntries - 1);
+		uint8_t* entry = &cache[index * entry_size];
+		uint8_t* value = entry + key_size;
+
+		if (cache_valid[index] && memcmp(entry, cache_key, key_size) == 0)
+		{
+			if (cache_validate)
+			{
+				sim_Blocks();
+				SaveState(cache_check);
+				if (memcmp(cache_check, value, value_size) != 0)
+				{
+					throw "The cached random logic state does not match the simulation!";
+				}
+			}
+			else
+			{
+				LoadState(value);
+			}
+			return;
+		}
+
+		sim_Blocks();
+
+		memcpy(entry, cache_key, key_size);
+		SaveState(value);
+		cache_valid[index] = true;
+	}
+
+	void RandomLogic::sim_Blocks()
 	{
 		// Register control
 
@@ -2041,8 +2351,119 @@ namespace M6502Core
 		branch_logic->sim();
 	}
 
+	size_t RandomLogic::SaveState(uint8_t* buf)
+	{
+		// The blocks do not have virtual methods, so their state is copied as is (along with the pointer to the core, which does not change).
+
+		uint8_t* p = buf;
+		memcpy(p, regs_control, sizeof(RegsControl));
+		p += sizeof(RegsControl);
+		memcpy(p, alu_control, sizeof(ALUControl));
+		p += sizeof(ALUControl);
+		memcpy(p, pc_control, sizeof(PC_Control));
+		p += sizeof(PC_Control);
+		memcpy(p, bus_control, sizeof(BusControl));
+		p += sizeof(BusControl);
+		memcpy(p, flags_control, sizeof(FlagsControl));
+		p += sizeof(FlagsControl);
+		memcpy(p, branch_logic, sizeof(BranchLogic));
+		p += sizeof(BranchLogic);
+		memcpy(p, &core->wire, sizeof(core->wire));
+		p += sizeof(core->wire);
+		memcpy(p, &core->cmd, sizeof(core->cmd));
+		p += sizeof(core->cmd);
+		return p - buf;
+	}
+
+	void RandomLogic::LoadState(uint8_t* buf)
+	{
+		uint8_t* p = buf;
+		memcpy(regs_control, p, sizeof(RegsControl));
+		p += sizeof(RegsControl);
+		memcpy(alu_control, p, sizeof(ALUControl));
+		p += sizeof(ALUControl);
+		memcpy(pc_control, p, sizeof(PC_Control));
+		p += sizeof(PC_Control);
+		memcpy(bus_control, p, sizeof(BusControl));
+		p += sizeof(BusControl);
+		memcpy(flags_control, p, sizeof(FlagsControl));
+		p += sizeof(FlagsControl);
+		memcpy(branch_logic, p, sizeof(BranchLogic));
+		p += sizeof(BranchLogic);
+		memcpy(&core->wire, p, sizeof(core->wire));
+		p += sizeof(core->wire);
+		memcpy(&core->cmd, p, sizeof(core->cmd));
+	}
+
+	void RandomLogic::MakeKey(uint8_t* key)
+	{
+		// The decoder outputs are not included, they are a function of IR and the T-counter.
+
+		uint8_t* p = key + SaveState(key);
+		memcpy(p, flags, sizeof(Flags));
+		p += sizeof(Flags);
+		*p++ = core->ir->IROut;
+		*p++ = (uint8_t)core->TxBits;
+		*p++ = (uint8_t)core->disp->getT1();
+		*p++ = core->DB & 0x80;
+		while (p < key + key_size)
+		{
+			*p++ = 0;
+		}
+	}
+
+	void RandomLogic::SetCache(bool enable, bool validate)
+	{
+		cache_validate = validate;
+
+		if (enable && cache == nullptr)
+		{
+			value_size = sizeof(RegsControl) + sizeof(ALUControl) + sizeof(PC_Control) + sizeof(BusControl) + sizeof(FlagsControl) + sizeof(BranchLogic) + sizeof(core->wire) + sizeof(core->cmd);
+			key_size = (value_size + sizeof(Flags) + 4 + 7) & ~7;
+			entry_size = key_size + value_size;
+
+			cache = new uint8_t[CacheEntries * entry_size];
+			cache_valid = new bool[CacheEntries];
+			memset(cache_valid, 0, CacheEntries * sizeof(bool));
+			cache_key = new uint8_t[key_size];
+			cache_check = new uint8_t[value_size];
+		}
+		else if (!enable && cache != nullptr)
+		{
+			delete[] cache;
+			delete[] cache_valid;
+			delete[] cache_key;
+			delete[] cache_check;
+			cache = nullptr;
+			cache_valid = nullptr;
+			cache_key = nullptr;
+			cache_check = nullptr;
+		}
+	}
+
+	// Put a value on an internal bus. If the bus has already been driven in this half-cycle, the ground wins.
+
+	static inline void DriveBus(uint8_t& bus, bool& dirty, uint8_t value)
+	{
+		if (dirty)
+		{
+			bus &= value;
+		}
+		else
+		{
+			bus = value;
+			dirty = true;
+		}
+	}
+
 	void AddressBus::sim_ConstGen()
 	{
+		if (HLE)
+		{
+			sim_ConstGenHLE();
+			return;
+		}
+
 		bool Z_ADL0 = core->cmd.Z_ADL0;
 		bool Z_ADL1 = core->cmd.Z_ADL1;
 		bool Z_ADL2 = core->cmd.Z_ADL2;
@@ -2075,6 +2496,21 @@ namespace M6502Core
 		}
 	}
 
+	void AddressBus::sim_ConstGenHLE()
+	{
+		uint8_t z_adl = 0;
+		z_adl |= core->cmd.Z_ADL0 ? 0b00000001 : 0;
+		z_adl |= core->cmd.Z_ADL1 ? 0b00000010 : 0;
+		z_adl |= core->cmd.Z_ADL2 ? 0b00000100 : 0;
+
+		uint8_t z_adh = 0;
+		z_adh |= core->cmd.Z_ADH0 ? 0b00000001 : 0;
+		z_adh |= core->cmd.Z_ADH17 ? 0b11111110 : 0;
+
+		core->ADL &= ~z_adl;
+		core->ADH &= ~z_adh;
+	}
+
 	void AddressBus::sim_Output(uint16_t* addr_bus)
 	{
 		TriState PHI1 = core->wire.PHI1;
@@ -2156,6 +2592,12 @@ namespace M6502Core
 
 	void Regs::sim_StoreSB()
 	{
+		if (HLE)
+		{
+			sim_StoreSBHLE();
+			return;
+		}
+
 		TriState PHI2 = core->wire.PHI2;
 		bool Y_SB = core->cmd.Y_SB;
 		bool X_SB = core->cmd.X_SB;
@@ -2206,6 +2648,26 @@ namespace M6502Core
 		}
 	}
 
+	void Regs::sim_StoreSBHLE()
+	{
+		if (core->wire.PHI2 == TriState::One)
+		{
+			S_out = ~S_in;
+		}
+
+		// All registers that drive SB are merged first, then the bus is driven once.
+
+		if (core->cmd.Y_SB || core->cmd.X_SB || core->cmd.S_SB)
+		{
+			uint8_t out = 0xff;
+			out &= core->cmd.S_SB ? ~S_out : 0xff;
+			out &= core->cmd.Y_SB ? Y : 0xff;
+			out &= core->cmd.X_SB ? X : 0xff;
+
+			DriveBus(core->SB, core->SB_Dirty, out);
+		}
+	}
+
 	void Regs::sim_StoreOldS()
 	{
 		bool S_ADL = core->cmd.S_ADL;
@@ -2251,6 +2713,7 @@ namespace M6502Core
 
 	void Regs::setS(uint8_t val)
 	{
+		S_in = val;
 		S_out = ~val;
 	}
 
@@ -3303,6 +3766,12 @@ namespace M6502Core
 
 	void DataBus::sim_SetExternalBus(uint8_t* data_bus)
 	{
+		if (HLE)
+		{
+			sim_SetExternalBusHLE(data_bus);
+			return;
+		}
+
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState WR = core->wire.WR;
@@ -3323,6 +3792,12 @@ namespace M6502Core
 
 	void DataBus::sim_GetExternalBus(uint8_t* data_bus)
 	{
+		if (HLE)
+		{
+			sim_GetExternalBusHLE(data_bus);
+			return;
+		}
+
 		TriState PHI1 = core->wire.PHI1;
 		TriState PHI2 = core->wire.PHI2;
 		TriState WR = core->wire.WR;
@@ -3381,6 +3856,48 @@ namespace M6502Core
 		}
 	}
 
+	// The data bus pads are driven (RD = 0) during PHI2 of a write cycle.
+
+	void DataBus::sim_SetExternalBusHLE(uint8_t* data_bus)
+	{
+		if (core->wire.PHI1 == TriState::One)
+		{
+			wr_latch = core->wire.WR == TriState::One;
+			DOR = ~(core->DB);
+		}
+
+		if (core->wire.PHI2 == TriState::One && wr_latch)
+		{
+			*data_bus = ~DOR;
+		}
+	}
+
+	void DataBus::sim_GetExternalBusHLE(uint8_t* data_bus)
+	{
+		if (core->wire.PHI2 == TriState::One)
+		{
+			DL = ~(*data_bus);
+			return;
+		}
+
+		wr_latch = core->wire.WR == TriState::One;
+
+		if (core->cmd.DL_ADL)
+		{
+			DriveBus(core->ADL, core->ADL_Dirty, ~DL);
+		}
+
+		if (core->cmd.DL_ADH)
+		{
+			DriveBus(core->ADH, core->ADH_Dirty, ~DL);
+		}
+
+		if (core->cmd.DL_DB)
+		{
+			DriveBus(core->DB, core->DB_Dirty, ~DL);
+		}
+	}
+
 	uint8_t DataBus::getDL()
 	{
 		return ~DL;
@@ -3415,12 +3932,14 @@ namespace M6502Core
 		disp = new Dispatcher(this);
 		random = new RandomLogic(this);
 
-		addr_bus = new AddressBus(this);
-		regs = new Regs(this);
+		addr_bus = new AddressBus(this, HLE_Mode);
+		regs = new Regs(this, HLE_Mode);
 		alu = new ALU(this);
 		alu->SetBCDHack(BCD_Hack);
 		pc = new ProgramCounter(this, HLE_Mode);
-		data_bus = new DataBus(this);
+		data_bus = new DataBus(this, HLE_Mode);
+
+		fast = new FastCore(this, BCD_Hack);
 	}
 
 	M6502::~M6502()
@@ -3438,6 +3957,9 @@ namespace M6502Core
 		delete alu;
 		delete pc;
 		delete data_bus;
+
+		delete fast;
+		delete trace;
 	}
 
 	void M6502::sim_Top(TriState inputs[], uint8_t* data_bus)
@@ -3498,43 +4020,7 @@ namespace M6502Core
 			ext->sim();
 		}
 
-		DecoderInput decoder_in{};
-
-		uint8_t IR = ir->IROut;
-
-		TriState IR0 = IR & 0b00000001 ? TriState::One : TriState::Zero;
-		TriState IR1 = IR & 0b00000010 ? TriState::One : TriState::Zero;
-		TriState IR2 = IR & 0b00000100 ? TriState::One : TriState::Zero;
-		TriState IR3 = IR & 0b00001000 ? TriState::One : TriState::Zero;
-		TriState IR4 = IR & 0b00010000 ? TriState::One : TriState::Zero;
-		TriState IR5 = IR & 0b00100000 ? TriState::One : TriState::Zero;
-		TriState IR6 = IR & 0b01000000 ? TriState::One : TriState::Zero;
-		TriState IR7 = IR & 0b10000000 ? TriState::One : TriState::Zero;
-
-		wire.n_IR5 = NOT(IR5);
-
-		decoder_in.n_IR0 = NOT(IR0);
-		decoder_in.n_IR1 = NOT(IR1);
-		decoder_in.IR01 = OR(IR0, IR1);
-		decoder_in.n_IR2 = NOT(IR2);
-		decoder_in.IR2 = IR2;
-		decoder_in.n_IR3 = NOT(IR3);
-		decoder_in.IR3 = IR3;
-		decoder_in.n_IR4 = NOT(IR4);
-		decoder_in.IR4 = IR4;
-		decoder_in.n_IR5 = wire.n_IR5;
-		decoder_in.IR5 = IR5;
-		decoder_in.n_IR6 = NOT(IR6);
-		decoder_in.IR6 = IR6;
-		decoder_in.n_IR7 = NOT(IR7);
-		decoder_in.IR7 = IR7;
-
-		decoder_in.n_T0 = wire.n_T0;
-		decoder_in.n_T1X = wire.n_T1X;
-		decoder_in.n_T2 = wire.n_T2;
-		decoder_in.n_T3 = wire.n_T3;
-		decoder_in.n_T4 = wire.n_T4;
-		decoder_in.n_T5 = wire.n_T5;
+		wire.n_IR5 = ir->IROut & 0b00100000 ? TriState::Zero : TriState::One;
 
 		TxBits = 0;
 		TxBits |= ((size_t)wire.n_T0 << 0);
@@ -3544,7 +4030,9 @@ namespace M6502Core
 		TxBits |= ((size_t)wire.n_T4 << 4);
 		TxBits |= ((size_t)wire.n_T5 << 5);
 
-		decoder->sim(decoder_in.packed_bits, &decoder_out);
+		// The decoder inputs are derived from IR and the T-counter only, so all 130 outputs are taken from the table at once.
+
+		decoder_mask = decoder->sim_Mask(ir->IROut, TxBits);
 
 		// Interrupt handling
 
@@ -3656,6 +4144,211 @@ namespace M6502Core
 	}
 
 	void M6502::sim(TriState inputs[], TriState outputs[], uint16_t* addr_bus, uint8_t* data_bus)
+	{
+		sim_Engine(inputs, outputs, addr_bus, data_bus);
+
+		// The trace is taken at PHI2, when the address and data buses are settled.
+
+		if (inputs[(size_t)InputPad::PHI0] == TriState::One)
+		{
+			if (outputs[(size_t)OutputPad::SYNC] == TriState::One)
+			{
+				InstructionPC = *addr_bus;
+			}
+
+			if (trace != nullptr)
+			{
+				trace->sim(outputs, *addr_bus, *data_bus);
+			}
+		}
+	}
+
+	void M6502::sim_Engine(TriState inputs[], TriState outputs[], uint16_t* addr_bus, uint8_t* data_bus)
+	{
+		TriState PHI0 = inputs[(size_t)InputPad::PHI0];
+
+		if (PHI0 == TriState::One)
+		{
+			TriState n_NMI = inputs[(size_t)InputPad::n_NMI];
+			TriState n_IRQ = inputs[(size_t)InputPad::n_IRQ];
+
+			if (n_NMI != nNMI_Quiet || n_IRQ != nIRQ_Quiet)
+			{
+				nNMI_Quiet = n_NMI;
+				nIRQ_Quiet = n_IRQ;
+				QuietCycles = 0;
+			}
+			else if (inputs[(size_t)InputPad::RDY] == TriState::One)
+			{
+				QuietCycles++;
+			}
+		}
+
+		if (FastActive)
+		{
+			bool reset = inputs[(size_t)InputPad::n_RES] == TriState::Zero;
+
+			if (!reset && (FastMode || !fast->ExitToGate(false)))
+			{
+				fast->sim(inputs, outputs, addr_bus, data_bus);
+				return;
+			}
+
+			// On /RES the gate-level core takes over in any case. The reset brings it to a known state, so only the registers are carried over.
+			// The dummy reads while /RES = 0 may differ from those of a gate-level core that has been running all the time.
+
+			if (reset && !fast->ExitToGate(true))
+			{
+				UserRegs regs{};
+				GetUserRegs(regs);
+				SetGateRegs(regs);
+			}
+
+			FastActive = false;
+		}
+
+		sim_Gate(inputs, outputs, addr_bus, data_bus);
+
+		// Take over at the second cycle of an instruction, if nothing is going on with the interrupts and RDY.
+		// By that time the gate-level core has written back the results of the previous instruction.
+
+		if (PHI0 == TriState::One && fast != nullptr)
+		{
+			bool prepared = fast->entry_prepared;
+			fast->entry_prepared = false;
+
+			bool quiet =
+				FastMode &&
+				outputs[(size_t)OutputPad::RnW] == TriState::One &&
+				inputs[(size_t)InputPad::RDY] == TriState::One &&
+				inputs[(size_t)InputPad::n_RES] == TriState::One &&
+				QuietCycles >= QuietCyclesRequired;
+
+			if (prepared)
+			{
+				if (quiet && outputs[(size_t)OutputPad::SYNC] == TriState::Zero)
+				{
+					fast->EnterFromGate(inputs, *data_bus);
+					FastActive = true;
+				}
+			}
+			else if (quiet &&
+				outputs[(size_t)OutputPad::SYNC] == TriState::One &&
+				wire.RESP == TriState::Zero &&
+				brk->getDORES() == TriState::Zero &&
+				brk->getB_OUT(wire.BRK6E) == TriState::One)
+			{
+				fast->PrepareEntry(inputs, *addr_bus, *data_bus);
+			}
+		}
+	}
+
+	void M6502::SetFastMode(bool enable)
+	{
+		if (fast != nullptr)
+		{
+			FastMode = enable;
+		}
+	}
+
+	bool M6502::IsFastModeActive()
+	{
+		return FastActive;
+	}
+
+	void M6502::SetCommandCache(bool enable, bool validate)
+	{
+		random->SetCache(enable, validate);
+	}
+
+	void M6502::SetTrace(size_t entries)
+	{
+		delete trace;
+		trace = nullptr;
+
+		if (entries != 0)
+		{
+			trace = new Tracer(this, entries);
+		}
+	}
+
+	Tracer* M6502::GetTrace()
+	{
+		return trace;
+	}
+
+	void M6502::GetUserRegs(UserRegs& user)
+	{
+		user.PC = InstructionPC;
+
+		// The fast engine runs ahead of the gate-level core within an instruction, so the state at the beginning of the current instruction is taken.
+		// For the gate-level core it is the same thing from the second cycle of the instruction on.
+
+		if (FastActive)
+		{
+			user.A = fast->start_A;
+			user.X = fast->start_X;
+			user.Y = fast->start_Y;
+			user.S = fast->start_S;
+			user.P = fast->start_P | 0x20;
+			return;
+		}
+
+		user.A = alu->getAC();
+		user.X = regs->getX();
+		user.Y = regs->getY();
+		user.S = regs->getS();
+		user.P = 0x20;
+		user.P |= NOT(random->flags->getn_C_OUT()) ? 0x01 : 0;
+		user.P |= NOT(random->flags->getn_Z_OUT()) ? 0x02 : 0;
+		user.P |= NOT(random->flags->getn_I_OUT(wire.BRK6E)) ? 0x04 : 0;
+		user.P |= NOT(random->flags->getn_D_OUT()) ? 0x08 : 0;
+		user.P |= NOT(random->flags->getn_V_OUT()) ? 0x40 : 0;
+		user.P |= NOT(random->flags->getn_N_OUT()) ? 0x80 : 0;
+	}
+
+	void M6502::SetUserRegs(UserRegs& user)
+	{
+		if (FastActive)
+		{
+			fast->A = fast->start_A = user.A;
+			fast->X = fast->start_X = user.X;
+			fast->Y = fast->start_Y = user.Y;
+			fast->S = fast->start_S = user.S;
+			fast->P = fast->start_P = user.P & ~(FastCore::B_FLAG | FastCore::U_FLAG);
+			fast->PC = user.PC;
+			if (fast->next_sync)
+			{
+				fast->next_addr = user.PC;		// The opcode fetch has already been requested
+			}
+			return;
+		}
+
+		SetGateRegs(user);
+	}
+
+	void M6502::SetGateRegs(UserRegs& user)
+	{
+		alu->setAC(user.A);
+		regs->setX(user.X);
+		regs->setY(user.Y);
+		regs->setS(user.S);
+		random->flags->set_C_OUT(user.P & 0x01 ? TriState::One : TriState::Zero);
+		random->flags->set_Z_OUT(user.P & 0x02 ? TriState::One : TriState::Zero);
+		random->flags->set_I_OUT(user.P & 0x04 ? TriState::One : TriState::Zero);
+		random->flags->set_D_OUT(user.P & 0x08 ? TriState::One : TriState::Zero);
+		random->flags->set_V_OUT(user.P & 0x40 ? TriState::One : TriState::Zero);
+		random->flags->set_N_OUT(user.P & 0x80 ? TriState::One : TriState::Zero);
+
+		// The program counter is taken from the PCLS/PCHS latches on the next PHI2, so they are set as well.
+
+		pc->setPCL(user.PC & 0xff);
+		pc->setPCLS(user.PC & 0xff);
+		pc->setPCH(user.PC >> 8);
+		pc->setPCHS(user.PC >> 8);
+	}
+
+	void M6502::sim_Gate(TriState inputs[], TriState outputs[], uint16_t* addr_bus, uint8_t* data_bus)
 	{
 		TriState PHI0 = inputs[(size_t)InputPad::PHI0];
 		TriState PHI2 = PHI0;
@@ -22,6 +22,8 @@
 namespace M6502Core
 {
 	class M6502;
+	class FastCore;
+	class Tracer;
 
 	union DecoderInput
 	{
@@ -52,18 +54,98 @@ namespace M6502Core
 		size_t packed_bits;
 	};
 
+	/// <summary>
+	/// Decoder outputs packed into a bit vector: output `n` is bit `n % 64` of word `n / 64`.
+	/// The same type is used as a selector of several outputs, so that a multi-input NOR/OR of the decoder lines is a couple of word-wide AND operations.
+	/// </summary>
+	struct DecoderMask
+	{
+		uint64_t w[3];
+
+		constexpr DecoderMask operator|(const DecoderMask& other) const
+		{
+			return { { w[0] | other.w[0], w[1] | other.w[1], w[2] | other.w[2] } };
+		}
+
+		constexpr DecoderMask operator&(const DecoderMask& other) const
+		{
+			return { { w[0] & other.w[0], w[1] & other.w[1], w[2] & other.w[2] } };
+		}
+
+		/// <summary>
+		/// Get decoder output `n`.
+		/// </summary>
+		inline BaseLogic::TriState out(size_t n) const
+		{
+			return (w[n >> 6] >> (n & 63)) & 1 ? BaseLogic::TriState::One : BaseLogic::TriState::Zero;
+		}
+
+		/// <summary>
+		/// OR of the selected decoder outputs.
+		/// </summary>
+		inline BaseLogic::TriState any(const DecoderMask& sel) const
+		{
+			return ((w[0] & sel.w[0]) | (w[1] & sel.w[1]) | (w[2] & sel.w[2])) != 0 ? BaseLogic::TriState::One : BaseLogic::TriState::Zero;
+		}
+
+		/// <summary>
+		/// NOR of the selected decoder outputs.
+		/// </summary>
+		inline BaseLogic::TriState nor(const DecoderMask& sel) const
+		{
+			return ((w[0] & sel.w[0]) | (w[1] & sel.w[1]) | (w[2] & sel.w[2])) != 0 ? BaseLogic::TriState::Zero : BaseLogic::TriState::One;
+		}
+	};
+
+	/// <summary>
+	/// Selector of decoder output `n`.
+	/// </summary>
+	constexpr DecoderMask DecoderOut(size_t n)
+	{
+		return { { n < 64 ? (1ULL << n) : 0, (n >= 64 && n < 128) ? (1ULL << (n - 64)) : 0, n >= 128 ? (1ULL << (n - 128)) : 0 } };
+	}
+
+	/// <summary>
+	/// Selector of decoder outputs `first` ... `last` inclusive.
+	/// </summary>
+	constexpr DecoderMask DecoderRange(size_t first, size_t last)
+	{
+		return first == last ? DecoderOut(first) : (DecoderOut(first) | DecoderRange(first + 1, last));
+	}
+
 	class Decoder
 	{
-		BaseLogic::PLA* pla = nullptr;
+		// The matrix is fixed silicon, so there is no PLA lookup table: each term is split into the part that depends on IR and the part that depends on the T-counter.
+		// The lookup tables of the core (here and in PreDecode, RegsControl, ALUControl and FlagsControl) are static: they are shared by all instances and filled by the constructor of the first one, through the initialization of a local static, which is thread-safe.
+
+		static DecoderMask ir_tab[0x100];
+		static DecoderMask tx_tab[0x40];
+
+		static bool PreCalcMask();
+		static DecoderMask MakeMask(size_t input_bits);
 
 	public:
 		static const size_t inputs_count = 21;
 		static const size_t outputs_count = 130;
 
+	private:
+		BaseLogic::TriState decoder_out[outputs_count]{};		// Outputs for sim()
+
+	public:
 		Decoder();
 		~Decoder();
 
 		void sim(size_t input_bits, BaseLogic::TriState** outputs);
+
+		/// <summary>
+		/// Get all decoder outputs as a bit vector.
+		/// </summary>
+		/// <param name="ir">IR value</param>
+		/// <param name="tx_bits">n_T0, n_T1X, n_T2, n_T3, n_T4, n_T5 (lsb -> msb)</param>
+		inline DecoderMask sim_Mask(uint8_t ir, size_t tx_bits)
+		{
+			return ir_tab[ir] & tx_tab[tx_bits];
+		}
 	};
 
 	class IR
@@ -87,8 +169,10 @@ namespace M6502Core
 
 		M6502* core = nullptr;
 
-		BaseLogic::TriState precalc_n_TWOCYCLE[0x100];
-		BaseLogic::TriState precalc_n_IMPLIED[0x100];
+		static BaseLogic::TriState precalc_n_TWOCYCLE[0x100];
+		static BaseLogic::TriState precalc_n_IMPLIED[0x100];
+
+		static bool PreCalc();
 
 	public:
 
@@ -185,9 +269,30 @@ namespace M6502Core
 
 		M6502* core = nullptr;
 
+		// HLE: the flag latches packed in the order of the P register bits (the bits of B and 5 are not used).
+		bool HLE = false;
+		uint8_t latch1 = 0;
+		uint8_t latch2 = 0;
+
+		static const uint8_t C_FLAG = 0x01;
+		static const uint8_t Z_FLAG = 0x02;
+		static const uint8_t I_FLAG = 0x04;
+		static const uint8_t D_FLAG = 0x08;
+		static const uint8_t V_FLAG = 0x40;
+		static const uint8_t N_FLAG = 0x80;
+		static const uint8_t ALL_FLAGS = C_FLAG | Z_FLAG | I_FLAG | D_FLAG | V_FLAG | N_FLAG;
+
+		void sim_LoadHLE();
+		void sim_StoreHLE();
+		void set_HLE(uint8_t flag, BaseLogic::TriState val);
+
 	public:
 
-		Flags(M6502* parent) { core = parent; }
+		Flags(M6502* parent, bool hle)
+		{
+			core = parent;
+			HLE = hle;
+		}
 
 		void sim_Load();
 
@@ -237,10 +342,11 @@ namespace M6502Core
 
 		M6502* core = nullptr;
 
-		RegsControl_TempWire temp_tab[0x10000]{};
+		static RegsControl_TempWire temp_tab[0x10000];
 		RegsControl_TempWire prev_temp;
 
-		RegsControl_TempWire PreCalc(uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5, bool n_ready, bool n_ready_latch);
+		static bool PreCalcTable(Decoder* decoder);
+		static RegsControl_TempWire PreCalc(Decoder* decoder, uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5, bool n_ready, bool n_ready_latch);
 
 	public:
 
@@ -314,10 +420,11 @@ namespace M6502Core
 		BaseLogic::TriState BRX = BaseLogic::TriState::Zero;
 		BaseLogic::TriState n_ADD_SB7 = BaseLogic::TriState::Zero;
 
-		CarryBCD_TempWire temp_tab1[1 << 19];
+		static CarryBCD_TempWire temp_tab1[1 << 19];
 		CarryBCD_TempWire prev_temp1;
 
-		CarryBCD_TempWire PreCalc1(uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5,
+		static bool PreCalcTable1(Decoder* decoder);
+		static CarryBCD_TempWire PreCalc1(Decoder* decoder, uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5,
 			bool n_ready, bool T0, bool T5, bool BRFW, bool n_C_OUT);
 
 	public:
@@ -440,7 +547,7 @@ namespace M6502Core
 
 		BaseLogic::TriState getT1();
 
-		BaseLogic::TriState getSTOR(BaseLogic::TriState d[]);
+		BaseLogic::TriState getSTOR(const DecoderMask& d);
 	};
 
 	union FlagsControl_TempWire
@@ -472,10 +579,11 @@ namespace M6502Core
 
 		M6502* core = nullptr;
 
-		FlagsControl_TempWire temp_tab[0x10000]{};
+		static FlagsControl_TempWire temp_tab[0x10000];
 		RegsControl_TempWire prev_temp;
 
-		FlagsControl_TempWire PreCalc(uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5, bool T5, bool T6);
+		static bool PreCalcTable(Decoder* decoder);
+		static FlagsControl_TempWire PreCalc(Decoder* decoder, uint8_t ir, bool n_T0, bool n_T1X, bool n_T2, bool n_T3, bool n_T4, bool n_T5, bool T5, bool T6);
 
 	public:
 
@@ -505,6 +613,26 @@ namespace M6502Core
 	{
 		M6502* core = nullptr;
 
+		// Memoization of the random logic (optional).
+		// The key is the state of the latches of all random logic blocks together with everything they read: the wires, the commands, the flags, IR, the T-counter and DB7.
+		// The value is the state of the latches, wires and commands after the simulation; on a hit it is written back, so all DLatch values remain observable.
+
+		static const size_t CacheEntries = 0x4000;		// Direct-mapped, must be a power of 2
+
+		uint8_t* cache = nullptr;
+		bool* cache_valid = nullptr;
+		uint8_t* cache_key = nullptr;
+		uint8_t* cache_check = nullptr;
+		size_t key_size = 0;		// Rounded up to 8 bytes for hashing
+		size_t value_size = 0;
+		size_t entry_size = 0;
+		bool cache_validate = false;
+
+		void sim_Blocks();
+		size_t SaveState(uint8_t* buf);
+		void LoadState(uint8_t* buf);
+		void MakeKey(uint8_t* key);
+
 	public:
 		RegsControl* regs_control = nullptr;
 		ALUControl* alu_control = nullptr;
@@ -518,6 +646,13 @@ namespace M6502Core
 		~RandomLogic();
 
 		void sim();
+
+		/// <summary>
+		/// Enable the memoization of the random logic.
+		/// </summary>
+		/// <param name="enable">true: use the cache</param>
+		/// <param name="validate">true: simulate the random logic on every hit anyway and compare the result with the cached one (an exception is thrown on mismatch)</param>
+		void SetCache(bool enable, bool validate);
 	};
 
 	class AddressBus
@@ -527,9 +662,17 @@ namespace M6502Core
 
 		M6502* core = nullptr;
 
+		bool HLE = false;
+
+		void sim_ConstGenHLE();
+
 	public:
 
-		AddressBus(M6502* parent) { core = parent; }
+		AddressBus(M6502* parent, bool hle)
+		{
+			core = parent;
+			HLE = hle;
+		}
 
 		void sim_ConstGen();
 
@@ -551,9 +694,17 @@ namespace M6502Core
 
 		M6502* core = nullptr;
 
+		bool HLE = false;
+
+		void sim_StoreSBHLE();
+
 	public:
 
-		Regs(M6502* parent) { core = parent; }
+		Regs(M6502* parent, bool hle)
+		{
+			core = parent;
+			HLE = hle;
+		}
 
 		void sim_LoadSB();
 
@@ -683,9 +834,20 @@ namespace M6502Core
 
 		M6502* core = nullptr;
 
+		// HLE
+		bool HLE = false;
+		bool wr_latch = false;		// rd_latch
+
+		void sim_SetExternalBusHLE(uint8_t* data_bus);
+		void sim_GetExternalBusHLE(uint8_t* data_bus);
+
 	public:
 
-		DataBus(M6502* parent) { core = parent; }
+		DataBus(M6502* parent, bool hle)
+		{
+			core = parent;
+			HLE = hle;
+		}
 
 		void sim_SetExternalBus(uint8_t* data_bus);
 
@@ -718,6 +880,19 @@ namespace M6502Core
 		Max,
 	};
 
+	/// <summary>
+	/// Architectural state of the 6502 (the registers visible to the program).
+	/// </summary>
+	struct UserRegs
+	{
+		uint16_t PC;
+		uint8_t A;
+		uint8_t X;
+		uint8_t Y;
+		uint8_t S;
+		uint8_t P;		// Bit 5 is always 1, the B flag is always 0 (it is not stored in the processor)
+	};
+
 	class M6502
 	{
 		friend IR;
@@ -738,6 +913,8 @@ namespace M6502Core
 		friend ALU;
 		friend ProgramCounter;
 		friend DataBus;
+		friend FastCore;
+		friend Tracer;
 
 		BaseLogic::FF nmip_ff;
 		BaseLogic::FF irqp_ff;
@@ -774,7 +951,7 @@ namespace M6502Core
 		ProgramCounter* pc = nullptr;
 		DataBus* data_bus = nullptr;
 
-		BaseLogic::TriState* decoder_out = nullptr;
+		DecoderMask decoder_mask{};
 		size_t TxBits = 0;		// Used to optimize table indexing
 
 		void sim_Top(BaseLogic::TriState inputs[], uint8_t* data_bus);
@@ -787,6 +964,28 @@ namespace M6502Core
 
 		bool HLE_Mode = false;		// Acceleration mode for fast applications. In this case we are cheating a little bit.
 
+		FastCore* fast = nullptr;
+		bool FastMode = false;			// Fast mode is requested
+		bool FastActive = false;		// The fast engine is running instead of the gate-level core
+
+		// The number of PHI2 half-cycles (with RDY = 1) since the last change of /NMI or /IRQ.
+		// The hand-off between the gate-level core and the fast engine is only made when there are no interrupt edges in flight.
+
+		size_t QuietCycles = 0;
+		BaseLogic::TriState nNMI_Quiet = BaseLogic::TriState::Z;
+		BaseLogic::TriState nIRQ_Quiet = BaseLogic::TriState::Z;
+		static const size_t QuietCyclesRequired = 32;
+
+		Tracer* trace = nullptr;		// Instruction trace (nullptr: disabled)
+
+		uint16_t InstructionPC = 0;		// The address of the last opcode fetch (SYNC = 1)
+
+		void sim_Engine(BaseLogic::TriState inputs[], BaseLogic::TriState outputs[], uint16_t* addr_bus, uint8_t* data_bus);
+
+		void sim_Gate(BaseLogic::TriState inputs[], BaseLogic::TriState outputs[], uint16_t* addr_bus, uint8_t* data_bus);
+
+		void SetGateRegs(UserRegs& regs);
+
 		/// <summary>
 		/// Internal auxiliary and intermediate connections.
 		/// </summary>
@@ -915,5 +1114,48 @@ namespace M6502Core
 		~M6502();
 
 		virtual void sim(BaseLogic::TriState inputs[], BaseLogic::TriState outputs[], uint16_t* addr_bus, uint8_t* data_bus);
+
+		/// <summary>
+		/// Switch between the gate-level simulation and the instruction-level engine (fast mode).
+		/// The switch happens at the next suitable instruction boundary, the architectural state (registers, flags, PC) is carried over.
+		/// In fast mode a falling edge of SO does not set the V flag (see 6502fast.h); on /RES the gate-level core takes over until the next instruction boundary.
+		/// </summary>
+		/// <param name="enable">true: fast mode</param>
+		void SetFastMode(bool enable);
+
+		/// <summary>
+		/// true: the instruction-level engine is currently running instead of the gate-level core.
+		/// </summary>
+		bool IsFastModeActive();
+
+		/// <summary>
+		/// Cache the control commands produced by the random logic for each state of the control unit, so that the repeating cycles of the instructions do not need to be simulated again.
+		/// </summary>
+		/// <param name="enable">true: use the cache</param>
+		/// <param name="validate">true: debug mode, the cached commands are checked against the simulation</param>
+		void SetCommandCache(bool enable, bool validate);
+
+		/// <summary>
+		/// Enable the instruction trace: a ring buffer of the last executed instructions (PC, opcode bytes, registers, cycle number).
+		/// </summary>
+		/// <param name="entries">Size of the ring buffer. 0: disable the trace</param>
+		void SetTrace(size_t entries);
+
+		/// <summary>
+		/// Get the instruction trace to read the records or to set up a file sink.
+		/// </summary>
+		/// <returns>nullptr: the trace is disabled</returns>
+		Tracer* GetTrace();
+
+		/// <summary>
+		/// Get the registers and flags as of the beginning of the current instruction; PC is the address of its opcode.
+		/// The result is valid from the second cycle of the instruction on: during the opcode fetch the previous instruction may still be writing back its result.
+		/// </summary>
+		void GetUserRegs(UserRegs& regs);
+
+		/// <summary>
+		/// Set the registers and flags. PC is loaded into the program counter, that is, it is the address of the next byte fetched from the instruction stream.
+		/// </summary>
+		void SetUserRegs(UserRegs& regs);
 	};
 }
\ No newline at end of file
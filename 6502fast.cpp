@@ -0,0 +1,1401 @@
+/*
+ * breakscore - Famicom functional simulator.
+ *
+ * Copyright (C) 2024 org
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Instruction-level 6502 engine (fast mode).
+// See 6502fast.h for the idea; the hand-off to the gate-level core is done by ExitToGate.
+
+#include "pch.h"
+
+using namespace BaseLogic;
+
+namespace M6502Core
+{
+	// Abbreviations for the opcode table
+
+	static constexpr FastAddrMode IMP = FastAddrMode::Implied;
+	static constexpr FastAddrMode IMM = FastAddrMode::Immediate;
+	static constexpr FastAddrMode ZPG = FastAddrMode::ZeroPage;
+	static constexpr FastAddrMode ZPX = FastAddrMode::ZeroPageX;
+	static constexpr FastAddrMode ZPY = FastAddrMode::ZeroPageY;
+	static constexpr FastAddrMode ABS = FastAddrMode::Absolute;
+	static constexpr FastAddrMode ABX = FastAddrMode::AbsoluteX;
+	static constexpr FastAddrMode ABY = FastAddrMode::AbsoluteY;
+	static constexpr FastAddrMode IZX = FastAddrMode::IndirectX;
+	static constexpr FastAddrMode IZY = FastAddrMode::IndirectY;
+	static constexpr FastAddrMode REL = FastAddrMode::Relative;
+	static constexpr FastAddrMode BRK = FastAddrMode::Break;
+	static constexpr FastAddrMode JSR = FastAddrMode::JumpSubroutine;
+	static constexpr FastAddrMode RTI = FastAddrMode::ReturnInterrupt;
+	static constexpr FastAddrMode RTS = FastAddrMode::ReturnSubroutine;
+	static constexpr FastAddrMode JMP = FastAddrMode::Jump;
+	static constexpr FastAddrMode JMI = FastAddrMode::JumpIndirect;
+	static constexpr FastAddrMode PSH = FastAddrMode::Push;
+	static constexpr FastAddrMode PUL = FastAddrMode::Pull;
+	static constexpr FastAddrMode HLT = FastAddrMode::Halt;
+
+	const FastOpcode FastCore::opcodes[0x100] =
+	{
+		// 0x00
+		{ BRK, FastOp::BRK }, { IZX, FastOp::ORA }, { HLT, FastOp::KIL }, { IZX, FastOp::SLO },
+		{ ZPG, FastOp::NOP }, { ZPG, FastOp::ORA }, { ZPG, FastOp::ASL }, { ZPG, FastOp::SLO },
+		{ PSH, FastOp::PHP }, { IMM, FastOp::ORA }, { IMP, FastOp::ASL }, { IMM, FastOp::ANC },
+		{ ABS, FastOp::NOP }, { ABS, FastOp::ORA }, { ABS, FastOp::ASL }, { ABS, FastOp::SLO },
+		// 0x10
+		{ REL, FastOp::BPL }, { IZY, FastOp::ORA }, { HLT, FastOp::KIL }, { IZY, FastOp::SLO },
+		{ ZPX, FastOp::NOP }, { ZPX, FastOp::ORA }, { ZPX, FastOp::ASL }, { ZPX, FastOp::SLO },
+		{ IMP, FastOp::CLC }, { ABY, FastOp::ORA }, { IMP, FastOp::NOP }, { ABY, FastOp::SLO },
+		{ ABX, FastOp::NOP }, { ABX, FastOp::ORA }, { ABX, FastOp::ASL }, { ABX, FastOp::SLO },
+		// 0x20
+		{ JSR, FastOp::JSR }, { IZX, FastOp::AND }, { HLT, FastOp::KIL }, { IZX, FastOp::RLA },
+		{ ZPG, FastOp::BIT }, { ZPG, FastOp::AND }, { ZPG, FastOp::ROL }, { ZPG, FastOp::RLA },
+		{ PUL, FastOp::PLP }, { IMM, FastOp::AND }, { IMP, FastOp::ROL }, { IMM, FastOp::ANC },
+		{ ABS, FastOp::BIT }, { ABS, FastOp::AND }, { ABS, FastOp::ROL }, { ABS, FastOp::RLA },
+		// 0x30
+		{ REL, FastOp::BMI }, { IZY, FastOp::AND }, { HLT, FastOp::KIL }, { IZY, FastOp::RLA },
+		{ ZPX, FastOp::NOP }, { ZPX, FastOp::AND }, { ZPX, FastOp::ROL }, { ZPX, FastOp::RLA },
+		{ IMP, FastOp::SEC }, { ABY, FastOp::AND }, { IMP, FastOp::NOP }, { ABY, FastOp::RLA },
+		{ ABX, FastOp::NOP }, { ABX, FastOp::AND }, { ABX, FastOp::ROL }, { ABX, FastOp::RLA },
+		// 0x40
+		{ RTI, FastOp::RTI }, { IZX, FastOp::EOR }, { HLT, FastOp::KIL }, { IZX, FastOp::SRE },
+		{ ZPG, FastOp::NOP }, { ZPG, FastOp::EOR }, { ZPG, FastOp::LSR }, { ZPG, FastOp::SRE },
+		{ PSH, FastOp::PHA }, { IMM, FastOp::EOR }, { IMP, FastOp::LSR }, { IMM, FastOp::ALR },
+		{ JMP, FastOp::JMP }, { ABS, FastOp::EOR }, { ABS, FastOp::LSR }, { ABS, FastOp::SRE },
+		// 0x50
+		{ REL, FastOp::BVC }, { IZY, FastOp::EOR }, { HLT, FastOp::KIL }, { IZY, FastOp::SRE },
+		{ ZPX, FastOp::NOP }, { ZPX, FastOp::EOR }, { ZPX, FastOp::LSR }, { ZPX, FastOp::SRE },
+		{ IMP, FastOp::CLI }, { ABY, FastOp::EOR }, { IMP, FastOp::NOP }, { ABY, FastOp::SRE },
+		{ ABX, FastOp::NOP }, { ABX, FastOp::EOR }, { ABX, FastOp::LSR }, { ABX, FastOp::SRE },
+		// 0x60
+		{ RTS, FastOp::RTS }, { IZX, FastOp::ADC }, { HLT, FastOp::KIL }, { IZX, FastOp::RRA },
+		{ ZPG, FastOp::NOP }, { ZPG, FastOp::ADC }, { ZPG, FastOp::ROR }, { ZPG, FastOp::RRA },
+		{ PUL, FastOp::PLA }, { IMM, FastOp::ADC }, { IMP, FastOp::ROR }, { IMM, FastOp::ARR },
+		{ JMI, FastOp::JMP }, { ABS, FastOp::ADC }, { ABS, FastOp::ROR }, { ABS, FastOp::RRA },
+		// 0x70
+		{ REL, FastOp::BVS }, { IZY, FastOp::ADC }, { HLT, FastOp::KIL }, { IZY, FastOp::RRA },
+		{ ZPX, FastOp::NOP }, { ZPX, FastOp::ADC }, { ZPX, FastOp::ROR }, { ZPX, FastOp::RRA },
+		{ IMP, FastOp::SEI }, { ABY, FastOp::ADC }, { IMP, FastOp::NOP }, { ABY, FastOp::RRA },
+		{ ABX, FastOp::NOP }, { ABX, FastOp::ADC }, { ABX, FastOp::ROR }, { ABX, FastOp::RRA },
+		// 0x80
+		{ IMM, FastOp::NOP }, { IZX, FastOp::STA }, { IMM, FastOp::NOP }, { IZX, FastOp::SAX },
+		{ ZPG, FastOp::STY }, { ZPG, FastOp::STA }, { ZPG, FastOp::STX }, { ZPG, FastOp::SAX },
+		{ IMP, FastOp::DEY }, { IMM, FastOp::NOP }, { IMP, FastOp::TXA }, { IMM, FastOp::ANE },
+		{ ABS, FastOp::STY }, { ABS, FastOp::STA }, { ABS, FastOp::STX }, { ABS, FastOp::SAX },
+		// 0x90
+		{ REL, FastOp::BCC }, { IZY, FastOp::STA }, { HLT, FastOp::KIL }, { IZY, FastOp::SHA },
+		{ ZPX, FastOp::STY }, { ZPX, FastOp::STA }, { ZPY, FastOp::STX }, { ZPY, FastOp::SAX },
+		{ IMP, FastOp::TYA }, { ABY, FastOp::STA }, { IMP, FastOp::TXS }, { ABY, FastOp::TAS },
+		{ ABX, FastOp::SHY }, { ABX, FastOp::STA }, { ABY, FastOp::SHX }, { ABY, FastOp::SHA },
+		// 0xA0
+		{ IMM, FastOp::LDY }, { IZX, FastOp::LDA }, { IMM, FastOp::LDX }, { IZX, FastOp::LAX },
+		{ ZPG, FastOp::LDY }, { ZPG, FastOp::LDA }, { ZPG, FastOp::LDX }, { ZPG, FastOp::LAX },
+		{ IMP, FastOp::TAY }, { IMM, FastOp::LDA }, { IMP, FastOp::TAX }, { IMM, FastOp::LXA },
+		{ ABS, FastOp::LDY }, { ABS, FastOp::LDA }, { ABS, FastOp::LDX }, { ABS, FastOp::LAX },
+		// 0xB0
+		{ REL, FastOp::BCS }, { IZY, FastOp::LDA }, { HLT, FastOp::KIL }, { IZY, FastOp::LAX },
+		{ ZPX, FastOp::LDY }, { ZPX, FastOp::LDA }, { ZPY, FastOp::LDX }, { ZPY, FastOp::LAX },
+		{ IMP, FastOp::CLV }, { ABY, FastOp::LDA }, { IMP, FastOp::TSX }, { ABY, FastOp::LAS },
+		{ ABX, FastOp::LDY }, { ABX, FastOp::LDA }, { ABY, FastOp::LDX }, { ABY, FastOp::LAX },
+		// 0xC0
+		{ IMM, FastOp::CPY }, { IZX, FastOp::CMP }, { IMM, FastOp::NOP }, { IZX, FastOp::DCP },
+		{ ZPG, FastOp::CPY }, { ZPG, FastOp::CMP }, { ZPG, FastOp::DEC }, { ZPG, FastOp::DCP },
+		{ IMP, FastOp::INY }, { IMM, FastOp::CMP }, { IMP, FastOp::DEX }, { IMM, FastOp::AXS },
+		{ ABS, FastOp::CPY }, { ABS, FastOp::CMP }, { ABS, FastOp::DEC }, { ABS, FastOp::DCP },
+		// 0xD0
+		{ REL, FastOp::BNE }, { IZY, FastOp::CMP }, { HLT, FastOp::KIL }, { IZY, FastOp::DCP },
+		{ ZPX, FastOp::NOP }, { ZPX, FastOp::CMP }, { ZPX, FastOp::DEC }, { ZPX, FastOp::DCP },
+		{ IMP, FastOp::CLD }, { ABY, FastOp::CMP }, { IMP, FastOp::NOP }, { ABY, FastOp::DCP },
+		{ ABX, FastOp::NOP }, { ABX, FastOp::CMP }, { ABX, FastOp::DEC }, { ABX, FastOp::DCP },
+		// 0xE0
+		{ IMM, FastOp::CPX }, { IZX, FastOp::SBC }, { IMM, FastOp::NOP }, { IZX, FastOp::ISC },
+		{ ZPG, FastOp::CPX }, { ZPG, FastOp::SBC }, { ZPG, FastOp::INC }, { ZPG, FastOp::ISC },
+		{ IMP, FastOp::INX }, { IMM, FastOp::SBC }, { IMP, FastOp::NOP }, { IMM, FastOp::SBC },
+		{ ABS, FastOp::CPX }, { ABS, FastOp::SBC }, { ABS, FastOp::INC }, { ABS, FastOp::ISC },
+		// 0xF0
+		{ REL, FastOp::BEQ }, { IZY, FastOp::SBC }, { HLT, FastOp::KIL }, { IZY, FastOp::ISC },
+		{ ZPX, FastOp::NOP }, { ZPX, FastOp::SBC }, { ZPX, FastOp::INC }, { ZPX, FastOp::ISC },
+		{ IMP, FastOp::SED }, { ABY, FastOp::SBC }, { IMP, FastOp::NOP }, { ABY, FastOp::ISC },
+		{ ABX, FastOp::NOP }, { ABX, FastOp::SBC }, { ABX, FastOp::INC }, { ABX, FastOp::ISC },
+	};
+
+	FastCore::FastCore(M6502* parent, bool BCD_Hack)
+	{
+		core = parent;
+		this->BCD_Hack = BCD_Hack;
+		HLE_ALU = parent->HLE_Mode && BCD_Hack;
+	}
+
+	FastCore::~FastCore()
+	{
+	}
+
+	void FastCore::sim(TriState inputs[], TriState outputs[], uint16_t* addr_bus, uint8_t* data_bus)
+	{
+		TriState PHI0 = inputs[(size_t)InputPad::PHI0];
+
+		if (PHI0 == TriState::Zero)
+		{
+			// PHI1: the bus request of the new cycle goes to the pads. If the previous cycle was not ready, the request is simply repeated.
+
+			addr = next_addr;
+			write = next_write;
+			sync = next_sync;
+			dor = next_data;
+
+			if (new_instruction)
+			{
+				new_instruction = false;
+				log_size = 0;
+
+				start_A = A;
+				start_X = X;
+				start_Y = Y;
+				start_S = S;
+				start_P = P;
+				start_PC = PC;
+
+				// After the reset done by ExitToGate the first instruction is always executed, so the instruction must not be replaced by an interrupt sequence.
+				// Without /RES the gate-level core can be restored at this point only if no pad has changed for a while (so no edge of /NMI is remembered).
+
+				start_nmi = core->nNMI_Quiet == TriState::Zero;
+				start_irq = core->nIRQ_Quiet == TriState::Zero;
+
+				instruction_replayable = take_interrupt == Interrupt::None;
+				instruction_start_clean =
+					instruction_replayable &&
+					core->QuietCycles >= M6502::QuietCyclesRequired &&
+					inputs[(size_t)InputPad::n_RES] == TriState::One;
+			}
+		}
+
+		if (log_size < LogMax)
+		{
+			LogEntry& entry = log[log_size++];
+			for (size_t n = 0; n < (size_t)InputPad::Max; n++)
+			{
+				entry.inputs[n] = inputs[n];
+			}
+			entry.data = *data_bus;
+		}
+		else if (state != State::Halt)
+		{
+			// A halted core repeats the same cycle, so for it the log that has been written is enough.
+
+			instruction_replayable = false;
+			instruction_start_clean = false;
+		}
+
+		if (PHI0 == TriState::One)
+		{
+			// PHI2: interrupt pads
+
+			DetectNMI(inputs[(size_t)InputPad::n_NMI] == TriState::Zero, inputs[(size_t)InputPad::RDY] != TriState::Zero || write);
+			irq_active = inputs[(size_t)InputPad::n_IRQ] == TriState::Zero;
+
+			// The read cycle is not completed while RDY = 0. Write cycles do not depend on RDY.
+
+			if (write)
+			{
+				*data_bus = dor;
+				Cycle(dor);
+			}
+			else if (inputs[(size_t)InputPad::RDY] != TriState::Zero)
+			{
+				Cycle(*data_bus);
+			}
+			else
+			{
+				// The interrupts are polled again while the cycle waits (an IRQ seen during the wait is not forgotten).
+				// CLI and SEI already take effect at this point.
+
+				if (state == State::Implied2 && opcode.op == FastOp::CLI)
+				{
+					P &= ~I_FLAG;
+				}
+				else if (state == State::Implied2 && opcode.op == FastOp::SEI)
+				{
+					P |= I_FLAG;
+				}
+				poll_history |= InterruptRequest() ? 1 : 0;
+				vector_stalled = state == State::Break7;
+
+				if (state == State::AbsoluteX4 || state == State::IndirectY5)
+				{
+					// While the dummy read of the indexed addressing waits, the final address gets through to the pads.
+					// The unstable stores lose the AND with the high part of the address + 1 in this case.
+					// When the address wraps from $FFxx to $00xx, the carry is lost again after the first repeated cycle.
+
+					next_addr = GetIndexedAddress();
+					carry_lost = base_hi == 0xff && (ea >> 8) == 0x00;
+					store_stalled = true;
+				}
+				else if (state == State::Relative4 && ea > PC)
+				{
+					// The same for the dummy read of the branch that crosses the page forward (the borrow is not fixed up this way).
+
+					next_addr = ea;
+				}
+			}
+		}
+
+		*addr_bus = addr;
+
+		outputs[(size_t)OutputPad::PHI1] = NOT(PHI0);
+		outputs[(size_t)OutputPad::PHI2] = PHI0;
+		outputs[(size_t)OutputPad::RnW] = write ? TriState::Zero : TriState::One;
+		outputs[(size_t)OutputPad::SYNC] = sync ? TriState::One : TriState::Zero;
+	}
+
+	void FastCore::Read(uint16_t address)
+	{
+		next_addr = address;
+		next_write = false;
+		next_sync = false;
+	}
+
+	void FastCore::Write(uint16_t address, uint8_t value)
+	{
+		next_addr = address;
+		next_write = true;
+		next_sync = false;
+		next_data = value;
+	}
+
+	void FastCore::Fetch()
+	{
+		state = State::Fetch;
+		next_addr = PC;
+		next_write = false;
+		next_sync = true;
+		new_instruction = true;
+	}
+
+	/// <summary>
+	/// NMI edge detection. Called on PHI2 before the cycle is processed and also covers PHI1 of the next cycle.
+	/// </summary>
+	/// <param name="nmi">/NMI = 0</param>
+	/// <param name="ready">The current cycle is completed (not stalled by RDY)</param>
+	void FastCore::DetectNMI(bool nmi, bool ready)
+	{
+		// BRK7 is low while P is pushed and the low byte of the vector is fetched; BRK6E marks the completed fetch.
+
+		bool brk7 = state != State::Break5 && state != State::Break6;
+		bool brk6e = state == State::Break6 && ready;
+
+		// PHI2
+
+		nmi_ff1 = !nmi_do && (nmi_ff1 || nmi_brk6e);
+		nmi_delay1 = !nmi_ff1;
+		nmi_ff2 = nmi_prev && (nmi_ff2 || nmi_delay2);
+		nmi_brk7 = brk7;
+
+		// PHI1 of the next cycle
+
+		nmi_brk6e = brk6e;
+		nmi_prev = nmi;
+		nmi_delay2 = nmi_delay1;
+		nmi_do = nmi_brk7 && nmi && !nmi_ff2 && !nmi_delay2;
+		nmi_pending = nmi_do || (!nmi_ff1 && !nmi_brk6e);
+	}
+
+	bool FastCore::InterruptRequest()
+	{
+		return nmi_pending || (irq_active && (P & I_FLAG) == 0);
+	}
+
+	/// <summary>
+	/// Complete the instruction and check the interrupts.
+	/// </summary>
+	/// <param name="poll_depth">Which cycle polled the interrupts, counting back from the current one (1: the next-to-last cycle). 0 - the interrupts are not polled.</param>
+	void FastCore::EndInstruction(size_t poll_depth)
+	{
+		take_interrupt = Interrupt::None;
+
+		if (poll_depth != 0 && (poll_history >> poll_depth) & 1)
+		{
+			take_interrupt = nmi_pending ? Interrupt::NMI : Interrupt::IRQ;
+		}
+
+		Fetch();
+	}
+
+	/// <summary>
+	/// Start the cycles that access the operand at the effective address.
+	/// </summary>
+	void FastCore::Access()
+	{
+		if (opcode.op >= FastOp::ASL)
+		{
+			Read(ea);
+			state = State::ModifyRead;
+		}
+		else if (opcode.op >= FastOp::STA)
+		{
+			Write(ea, GetStoreValue());
+			state = State::Store;
+		}
+		else
+		{
+			Read(ea);
+			state = State::Operand;
+		}
+	}
+
+	uint8_t FastCore::GetIndex()
+	{
+		switch (opcode.mode)
+		{
+			case FastAddrMode::ZeroPageY:
+			case FastAddrMode::AbsoluteY:
+			case FastAddrMode::IndirectY:
+				return Y;
+			default:
+				return X;
+		}
+	}
+
+	/// <summary>
+	/// Process the completed cycle and make a bus request for the next one.
+	/// </summary>
+	/// <param name="value">The value of the data bus (read or written)</param>
+	void FastCore::Cycle(uint8_t value)
+	{
+		poll_history = (poll_history << 1) | (InterruptRequest() ? 1 : 0);
+
+		switch (state)
+		{
+			case State::Fetch:
+				in_interrupt = take_interrupt != Interrupt::None;
+				if (in_interrupt)
+				{
+					// The fetched opcode is replaced by BRK and PC is not incremented.
+
+					opcode = opcodes[0];
+				}
+				else
+				{
+					opcode = opcodes[value];
+					PC++;
+				}
+				Read(PC);
+
+				switch (opcode.mode)
+				{
+					case FastAddrMode::Implied: state = State::Implied2; break;
+					case FastAddrMode::Immediate: state = State::Immediate2; break;
+					case FastAddrMode::ZeroPage: state = State::ZeroPage2; break;
+					case FastAddrMode::ZeroPageX: state = State::ZeroPageX2; break;
+					case FastAddrMode::ZeroPageY: state = State::ZeroPageX2; break;
+					case FastAddrMode::Absolute: state = State::Absolute2; break;
+					case FastAddrMode::AbsoluteX: state = State::AbsoluteX2; break;
+					case FastAddrMode::AbsoluteY: state = State::AbsoluteX2; break;
+					case FastAddrMode::IndirectX: state = State::IndirectX2; break;
+					case FastAddrMode::IndirectY: state = State::IndirectY2; break;
+					case FastAddrMode::Relative: state = State::Relative2; break;
+					case FastAddrMode::Break: state = State::Break2; break;
+					case FastAddrMode::JumpSubroutine: state = State::JumpSubroutine2; break;
+					case FastAddrMode::ReturnInterrupt: state = State::ReturnInterrupt2; break;
+					case FastAddrMode::ReturnSubroutine: state = State::ReturnSubroutine2; break;
+					case FastAddrMode::Jump: state = State::Jump2; break;
+					case FastAddrMode::JumpIndirect: state = State::JumpIndirect2; break;
+					case FastAddrMode::Push: state = State::Push2; break;
+					case FastAddrMode::Pull: state = State::Pull2; break;
+					case FastAddrMode::Halt: state = State::Halt2; break;
+				}
+				break;
+
+			// Operand addressing
+
+			case State::Implied2:
+				ExecuteImplied();
+				EndInstruction(1);
+				break;
+
+			case State::Immediate2:
+				PC++;
+				ExecuteRead(value);
+				EndInstruction(1);
+				break;
+
+			case State::ZeroPage2:
+				PC++;
+				ea = value;
+				Access();
+				break;
+
+			case State::ZeroPageX2:
+				PC++;
+				base_lo = value;
+				Read(base_lo);
+				state = State::ZeroPageX3;
+				break;
+
+			case State::ZeroPageX3:
+				ea = (uint8_t)(base_lo + GetIndex());
+				Access();
+				break;
+
+			case State::Absolute2:
+				PC++;
+				base_lo = value;
+				Read(PC);
+				state = State::Absolute3;
+				break;
+
+			case State::Absolute3:
+				PC++;
+				ea = ((uint16_t)value << 8) | base_lo;
+				Access();
+				break;
+
+			case State::AbsoluteX2:
+				PC++;
+				base_lo = value;
+				Read(PC);
+				state = State::AbsoluteX3;
+				break;
+
+			case State::AbsoluteX3:
+				PC++;
+				base_hi = value;
+				ea = (((uint16_t)base_hi << 8) | base_lo) + GetIndex();
+				Read(((uint16_t)base_hi << 8) | (ea & 0xff));
+				store_stalled = false;
+				carry_lost = false;
+				state = State::AbsoluteX4;
+				break;
+
+			case State::IndirectX2:
+				PC++;
+				base_lo = value;
+				Read(base_lo);
+				state = State::IndirectX3;
+				break;
+
+			case State::IndirectX3:
+				base_lo += X;
+				Read(base_lo);
+				state = State::IndirectX4;
+				break;
+
+			case State::IndirectX4:
+				data = value;
+				Read((uint8_t)(base_lo + 1));
+				state = State::IndirectX5;
+				break;
+
+			case State::IndirectX5:
+				ea = ((uint16_t)value << 8) | data;
+				Access();
+				break;
+
+			case State::IndirectY2:
+				PC++;
+				base_lo = value;
+				Read(base_lo);
+				state = State::IndirectY3;
+				break;
+
+			case State::IndirectY3:
+				data = value;
+				Read((uint8_t)(base_lo + 1));
+				state = State::IndirectY4;
+				break;
+
+			case State::IndirectY4:
+				base_lo = data;
+				base_hi = value;
+				ea = (((uint16_t)base_hi << 8) | base_lo) + Y;
+				Read(((uint16_t)base_hi << 8) | (ea & 0xff));
+				store_stalled = false;
+				carry_lost = false;
+				state = State::IndirectY5;
+				break;
+
+			case State::AbsoluteX4:
+			case State::IndirectY5:
+				// Dummy read from the address without the carry to the high part. For read instructions without a page crossing this is the operand itself.
+
+				if (opcode.op < FastOp::STA && (ea >> 8) == base_hi)
+				{
+					ExecuteRead(value);
+					EndInstruction(1);
+				}
+				else
+				{
+					ea = GetIndexedAddress();
+					Access();
+				}
+				break;
+
+			// Operand access
+
+			case State::Operand:
+				ExecuteRead(value);
+				EndInstruction(1);
+				break;
+
+			case State::Store:
+				EndInstruction(1);
+				break;
+
+			case State::ModifyRead:
+				data = value;
+				Write(ea, data);
+				state = State::ModifyDummy;
+				break;
+
+			case State::ModifyDummy:
+				data = ExecuteModify(data);
+				Write(ea, data);
+				state = State::ModifyWrite;
+				break;
+
+			case State::ModifyWrite:
+				EndInstruction(1);
+				break;
+
+			// Branches
+
+			case State::Relative2:
+				PC++;
+				if (!BranchTaken())
+				{
+					EndInstruction(1);
+					break;
+				}
+				ea = PC + (int8_t)value;
+				Read(PC);
+				state = State::Relative3;
+				break;
+
+			case State::Relative3:
+				if ((ea & 0xff00) == (PC & 0xff00))
+				{
+					// A taken branch without a page crossing does not poll the interrupts on its last cycle.
+
+					PC = ea;
+					EndInstruction(2);
+					break;
+				}
+				Read((PC & 0xff00) | (ea & 0xff));
+				state = State::Relative4;
+				break;
+
+			case State::Relative4:
+				// The interrupt seen by the poll that a branch without a page crossing uses (one cycle older by now) is taken as well.
+
+				PC = ea;
+				EndInstruction((poll_history & 0x08) != 0 ? 3 : 1);
+				break;
+
+			// BRK and interrupts
+
+			case State::Break2:
+				if (!in_interrupt)
+				{
+					PC++;
+				}
+				Write(0x100 | S, PC >> 8);
+				S--;
+				state = State::Break3;
+				break;
+
+			case State::Break3:
+				Write(0x100 | S, PC & 0xff);
+				S--;
+				state = State::Break4;
+				break;
+
+			case State::Break4:
+				Write(0x100 | S, P | U_FLAG | (in_interrupt ? 0 : B_FLAG));
+				S--;
+
+				// NMI can hijack the vector of BRK/IRQ, if its edge came before the cycle that pushes P
+
+				if (nmi_pending)
+				{
+					ea = 0xfffa;
+				}
+				else
+				{
+					ea = 0xfffe;
+				}
+				state = State::Break5;
+				break;
+
+			case State::Break5:
+				P |= I_FLAG;
+				Read(ea);
+				state = State::Break6;
+				break;
+
+			case State::Break6:
+				data = value;
+				Read(ea + 1);
+				vector_stalled = false;
+				state = State::Break7;
+				break;
+
+			case State::Break7:
+				// The interrupt sequence does not poll the interrupts, unless RDY holds the fetch of the high byte of the vector.
+
+				PC = ((uint16_t)value << 8) | data;
+				EndInstruction(vector_stalled ? 1 : 0);
+				break;
+
+			// Subroutines
+
+			case State::JumpSubroutine2:
+				PC++;
+				data = value;
+				Read(0x100 | S);
+				state = State::JumpSubroutine3;
+				break;
+
+			case State::JumpSubroutine3:
+				Write(0x100 | S, PC >> 8);
+				S--;
+				state = State::JumpSubroutine4;
+				break;
+
+			case State::JumpSubroutine4:
+				Write(0x100 | S, PC & 0xff);
+				S--;
+				state = State::JumpSubroutine5;
+				break;
+
+			case State::JumpSubroutine5:
+				Read(PC);
+				state = State::JumpSubroutine6;
+				break;
+
+			case State::JumpSubroutine6:
+				PC = ((uint16_t)value << 8) | data;
+				EndInstruction(1);
+				break;
+
+			case State::ReturnInterrupt2:
+				Read(0x100 | S);
+				state = State::ReturnInterrupt3;
+				break;
+
+			case State::ReturnInterrupt3:
+				S++;
+				Read(0x100 | S);
+				state = State::ReturnInterrupt4;
+				break;
+
+			case State::ReturnInterrupt4:
+				P = value & ~(B_FLAG | U_FLAG);
+				S++;
+				Read(0x100 | S);
+				state = State::ReturnInterrupt5;
+				break;
+
+			case State::ReturnInterrupt5:
+				data = value;
+				S++;
+				Read(0x100 | S);
+				state = State::ReturnInterrupt6;
+				break;
+
+			case State::ReturnInterrupt6:
+				PC = ((uint16_t)value << 8) | data;
+				EndInstruction(1);
+				break;
+
+			case State::ReturnSubroutine2:
+				Read(0x100 | S);
+				state = State::ReturnSubroutine3;
+				break;
+
+			case State::ReturnSubroutine3:
+				S++;
+				Read(0x100 | S);
+				state = State::ReturnSubroutine4;
+				break;
+
+			case State::ReturnSubroutine4:
+				data = value;
+				S++;
+				Read(0x100 | S);
+				state = State::ReturnSubroutine5;
+				break;
+
+			case State::ReturnSubroutine5:
+				PC = ((uint16_t)value << 8) | data;
+				Read(PC);
+				state = State::ReturnSubroutine6;
+				break;
+
+			case State::ReturnSubroutine6:
+				PC++;
+				EndInstruction(1);
+				break;
+
+			// Jumps
+
+			case State::Jump2:
+				PC++;
+				data = value;
+				Read(PC);
+				state = State::Jump3;
+				break;
+
+			case State::Jump3:
+				PC = ((uint16_t)value << 8) | data;
+				EndInstruction(1);
+				break;
+
+			case State::JumpIndirect2:
+				PC++;
+				data = value;
+				Read(PC);
+				state = State::JumpIndirect3;
+				break;
+
+			case State::JumpIndirect3:
+				// The pointer does not cross the page boundary
+
+				ea = ((uint16_t)value << 8) | data;
+				Read(ea);
+				state = State::JumpIndirect4;
+				break;
+
+			case State::JumpIndirect4:
+				data = value;
+				Read((ea & 0xff00) | ((ea + 1) & 0xff));
+				state = State::JumpIndirect5;
+				break;
+
+			case State::JumpIndirect5:
+				PC = ((uint16_t)value << 8) | data;
+				EndInstruction(1);
+				break;
+
+			// Stack
+
+			case State::Push2:
+				Write(0x100 | S, opcode.op == FastOp::PHA ? A : (P | U_FLAG | B_FLAG));
+				S--;
+				state = State::Push3;
+				break;
+
+			case State::Push3:
+				EndInstruction(1);
+				break;
+
+			case State::Pull2:
+				Read(0x100 | S);
+				state = State::Pull3;
+				break;
+
+			case State::Pull3:
+				S++;
+				Read(0x100 | S);
+				state = State::Pull4;
+				break;
+
+			case State::Pull4:
+				if (opcode.op == FastOp::PLA)
+				{
+					A = value;
+					SetNZ(A);
+				}
+				else
+				{
+					P = value & ~(B_FLAG | U_FLAG);
+				}
+				EndInstruction(1);
+				break;
+
+			case State::Halt2:
+				// The processor gets stuck until reset. Before that it touches the top of the address space a few times.
+
+				Read(0xffff);
+				state = State::Halt3;
+				break;
+
+			case State::Halt3:
+				Read(0xfffe);
+				state = State::Halt4;
+				break;
+
+			case State::Halt4:
+				Read(0xfffe);
+				state = State::Halt;
+				break;
+
+			case State::Halt:
+				Read(0xffff);
+				break;
+		}
+	}
+
+	void FastCore::SetNZ(uint8_t value)
+	{
+		P &= ~(N_FLAG | Z_FLAG);
+		P |= value & N_FLAG;
+		P |= value == 0 ? Z_FLAG : 0;
+	}
+
+	void FastCore::Compare(uint8_t reg, uint8_t value)
+	{
+		uint8_t res = reg - value;
+		P &= ~C_FLAG;
+		P |= reg >= value ? C_FLAG : 0;
+		SetNZ(res);
+	}
+
+	void FastCore::Add(uint8_t value)
+	{
+		unsigned carry = P & C_FLAG;
+		unsigned sum = A + value + carry;
+
+		P &= ~(C_FLAG | V_FLAG);
+
+		if ((P & D_FLAG) && !BCD_Hack)
+		{
+			// The NMOS 6502 takes N and V from the intermediate result (after the low nibble correction), Z from the binary result.
+
+			unsigned lo = (A & 0xf) + (value & 0xf) + carry;
+			if (lo > 9)
+			{
+				lo += 6;
+			}
+			unsigned hi = (A >> 4) + (value >> 4) + (lo > 0xf ? 1 : 0);
+
+			P &= ~(N_FLAG | Z_FLAG);
+			P |= (sum & 0xff) == 0 ? Z_FLAG : 0;
+			P |= (hi << 4) & N_FLAG;
+			P |= (~(A ^ value) & (A ^ (hi << 4)) & 0x80) ? V_FLAG : 0;
+
+			if (hi > 9)
+			{
+				hi += 6;
+			}
+			P |= hi > 0xf ? C_FLAG : 0;
+			A = (uint8_t)((hi << 4) | (lo & 0xf));
+			return;
+		}
+
+		P |= sum > 0xff ? C_FLAG : 0;
+		P |= (~(A ^ value) & (A ^ sum) & 0x80) ? V_FLAG : 0;
+		A = (uint8_t)sum;
+		SetNZ(A);
+	}
+
+	void FastCore::Subtract(uint8_t value)
+	{
+		unsigned borrow = (P & C_FLAG) ? 0 : 1;
+		unsigned diff = A - value - borrow;
+
+		// The flags are always taken from the binary result.
+
+		P &= ~(C_FLAG | V_FLAG);
+		P |= diff < 0x100 ? C_FLAG : 0;
+		P |= ((A ^ value) & (A ^ diff) & 0x80) ? V_FLAG : 0;
+
+		if ((P & D_FLAG) && !BCD_Hack)
+		{
+			int lo = (A & 0xf) - (value & 0xf) - (int)borrow;
+			int hi = (A >> 4) - (value >> 4);
+			if (lo & 0x10)
+			{
+				lo -= 6;
+				hi--;
+			}
+			if (hi & 0x10)
+			{
+				hi -= 6;
+			}
+			SetNZ((uint8_t)diff);
+			A = (uint8_t)((hi << 4) | (lo & 0xf));
+			return;
+		}
+
+		A = (uint8_t)diff;
+		SetNZ(A);
+	}
+
+	void FastCore::ExecuteRead(uint8_t value)
+	{
+		switch (opcode.op)
+		{
+			case FastOp::LDA:
+				A = value;
+				SetNZ(A);
+				break;
+			case FastOp::LDX:
+				X = value;
+				SetNZ(X);
+				break;
+			case FastOp::LDY:
+				Y = value;
+				SetNZ(Y);
+				break;
+			case FastOp::LAX:
+				A = X = value;
+				SetNZ(A);
+				break;
+			case FastOp::ADC:
+				Add(value);
+				break;
+			case FastOp::SBC:
+				Subtract(value);
+				break;
+			case FastOp::AND:
+				A &= value;
+				SetNZ(A);
+				break;
+			case FastOp::ORA:
+				A |= value;
+				SetNZ(A);
+				break;
+			case FastOp::EOR:
+				A ^= value;
+				SetNZ(A);
+				break;
+			case FastOp::CMP:
+				Compare(A, value);
+				break;
+			case FastOp::CPX:
+				Compare(X, value);
+				break;
+			case FastOp::CPY:
+				Compare(Y, value);
+				break;
+			case FastOp::BIT:
+				P &= ~(N_FLAG | V_FLAG | Z_FLAG);
+				P |= value & (N_FLAG | V_FLAG);
+				P |= (A & value) == 0 ? Z_FLAG : 0;
+				break;
+			case FastOp::ANC:
+				A &= value;
+				SetNZ(A);
+				P = (P & ~C_FLAG) | (HLE_ALU ? 0 : (A >> 7));
+				break;
+			case FastOp::ALR:
+				A &= value;
+				P = (P & ~C_FLAG) | (A & 1);
+				A >>= 1;
+				SetNZ(A);
+				break;
+			case FastOp::ARR:
+			{
+				uint8_t and_result = A & value;
+				A = (and_result >> 1) | ((P & C_FLAG) << 7);
+				SetNZ(A);
+				P &= ~(C_FLAG | V_FLAG);
+				if (HLE_ALU)
+				{
+					// The high-level ALU takes the carry only from the adder, V follows bit 6.
+					P |= (A & 0x40) ? V_FLAG : 0;
+				}
+				else if ((P & D_FLAG) && !BCD_Hack)
+				{
+					P |= ((A ^ and_result) & 0x40) ? V_FLAG : 0;
+					if ((and_result & 0xf) + (and_result & 1) > 5)
+					{
+						A = (A & 0xf0) | ((A + 6) & 0xf);
+					}
+					if ((and_result & 0xf0) + (and_result & 0x10) > 0x50)
+					{
+						A += 0x60;
+						P |= C_FLAG;
+					}
+				}
+				else
+				{
+					P |= (A >> 6) & 1;
+					P |= ((A >> 6) ^ (A >> 5)) & 1 ? V_FLAG : 0;
+				}
+				break;
+			}
+			case FastOp::AXS:
+				X &= A;
+				Compare(X, value);
+				X -= value;
+				break;
+			case FastOp::LAS:
+				A = X = S & value;
+				SetNZ(A);
+				break;
+			case FastOp::ANE:
+				A = A & X & value;
+				SetNZ(A);
+				break;
+			case FastOp::LXA:
+				A = X = A & value;
+				SetNZ(A);
+				break;
+			default:
+				break;
+		}
+	}
+
+	uint8_t FastCore::ExecuteModify(uint8_t value)
+	{
+		uint8_t carry = P & C_FLAG;
+
+		switch (opcode.op)
+		{
+			case FastOp::ASL:
+			case FastOp::SLO:
+				P = (P & ~C_FLAG) | (value >> 7);
+				value <<= 1;
+				break;
+			case FastOp::LSR:
+			case FastOp::SRE:
+				P = (P & ~C_FLAG) | (value & 1);
+				value >>= 1;
+				break;
+			case FastOp::ROL:
+			case FastOp::RLA:
+				P = (P & ~C_FLAG) | (value >> 7);
+				value = (value << 1) | carry;
+				break;
+			case FastOp::ROR:
+			case FastOp::RRA:
+				P = (P & ~C_FLAG) | (value & 1);
+				value = (value >> 1) | (carry << 7);
+				break;
+			case FastOp::INC:
+			case FastOp::ISC:
+				value++;
+				break;
+			case FastOp::DEC:
+			case FastOp::DCP:
+				value--;
+				break;
+			default:
+				break;
+		}
+
+		switch (opcode.op)
+		{
+			case FastOp::SLO:
+				A |= value;
+				SetNZ(A);
+				break;
+			case FastOp::RLA:
+				A &= value;
+				SetNZ(A);
+				break;
+			case FastOp::SRE:
+				A ^= value;
+				SetNZ(A);
+				break;
+			case FastOp::RRA:
+				Add(value);
+				break;
+			case FastOp::DCP:
+				Compare(A, value);
+				break;
+			case FastOp::ISC:
+				Subtract(value);
+				break;
+			default:
+				SetNZ(value);
+				break;
+		}
+
+		return value;
+	}
+
+	uint16_t FastCore::GetIndexedAddress()
+	{
+		uint8_t hi = carry_lost ? 0xff : (ea >> 8);
+
+		if ((opcode.op == FastOp::SHA || opcode.op == FastOp::TAS) && (ea >> 8) != base_hi)
+		{
+			// SHA and TAS put A AND (high part of the base address + 1) on the high part of the address when the page is crossed.
+
+			hi &= A;
+		}
+		return ((uint16_t)hi << 8) | (ea & 0xff);
+	}
+
+	uint8_t FastCore::GetStoreValue()
+	{
+		// The unstable stores behave as the gate-level core does (which differs from some of the real chips):
+		// SHA and TAS store A AND (high part of the base address + 1), SHX and SHY store the high part + 1 as is.
+		// If RDY has stopped the processor on the dummy read, the high part does not take part.
+
+		uint8_t hi = store_stalled ? 0xff : base_hi + 1;
+
+		switch (opcode.op)
+		{
+			case FastOp::STA: return A;
+			case FastOp::STX: return X;
+			case FastOp::STY: return Y;
+			case FastOp::SAX: return A & X;
+			case FastOp::SHA: return A & hi;
+			case FastOp::SHX: return hi;
+			case FastOp::SHY: return hi;
+			case FastOp::TAS:
+				S = A & X;
+				return A & hi;
+			default:
+				return 0;
+		}
+	}
+
+	void FastCore::ExecuteImplied()
+	{
+		switch (opcode.op)
+		{
+			case FastOp::TAX:
+				X = A;
+				SetNZ(X);
+				break;
+			case FastOp::TAY:
+				Y = A;
+				SetNZ(Y);
+				break;
+			case FastOp::TXA:
+				A = X;
+				SetNZ(A);
+				break;
+			case FastOp::TYA:
+				A = Y;
+				SetNZ(A);
+				break;
+			case FastOp::TSX:
+				X = S;
+				SetNZ(X);
+				break;
+			case FastOp::TXS:
+				S = X;
+				break;
+			case FastOp::INX:
+				X++;
+				SetNZ(X);
+				break;
+			case FastOp::INY:
+				Y++;
+				SetNZ(Y);
+				break;
+			case FastOp::DEX:
+				X--;
+				SetNZ(X);
+				break;
+			case FastOp::DEY:
+				Y--;
+				SetNZ(Y);
+				break;
+			case FastOp::CLC: P &= ~C_FLAG; break;
+			case FastOp::SEC: P |= C_FLAG; break;
+			case FastOp::CLI: P &= ~I_FLAG; break;
+			case FastOp::SEI: P |= I_FLAG; break;
+			case FastOp::CLV: P &= ~V_FLAG; break;
+			case FastOp::CLD: P &= ~D_FLAG; break;
+			case FastOp::SED: P |= D_FLAG; break;
+			case FastOp::ASL:
+			case FastOp::LSR:
+			case FastOp::ROL:
+			case FastOp::ROR:
+				A = ExecuteModify(A);
+				break;
+			default:
+				break;
+		}
+	}
+
+	bool FastCore::BranchTaken()
+	{
+		static const uint8_t flag[4] = { N_FLAG, V_FLAG, C_FLAG, Z_FLAG };
+
+		size_t n = (size_t)opcode.op - (size_t)FastOp::BPL;
+		bool set = (P & flag[n >> 1]) != 0;
+		return (n & 1) ? set : !set;
+	}
+
+	void FastCore::PrepareEntry(TriState inputs[], uint16_t fetch_addr, uint8_t fetch_data)
+	{
+		start_PC = fetch_addr;
+
+		log_size = 0;
+		LogCycle(inputs, fetch_data);
+		entry_prepared = true;
+	}
+
+	void FastCore::EnterFromGate(TriState inputs[], uint8_t data_bus)
+	{
+		// The previous instruction has finished its register writes by now, and the current one has not started them yet.
+
+		A = core->alu->getAC();
+		X = core->regs->getX();
+		Y = core->regs->getY();
+		S = core->regs->getS();
+		P = 0;
+		P |= NOT(core->random->flags->getn_C_OUT()) ? C_FLAG : 0;
+		P |= NOT(core->random->flags->getn_Z_OUT()) ? Z_FLAG : 0;
+		P |= NOT(core->random->flags->getn_I_OUT(core->wire.BRK6E)) ? I_FLAG : 0;
+		P |= NOT(core->random->flags->getn_D_OUT()) ? D_FLAG : 0;
+		P |= NOT(core->random->flags->getn_V_OUT()) ? V_FLAG : 0;
+		P |= NOT(core->random->flags->getn_N_OUT()) ? N_FLAG : 0;
+		PC = start_PC;
+
+		// The pads have not changed for a while, so there are no interrupt edges to remember.
+
+		nmi_prev = inputs[(size_t)InputPad::n_NMI] == TriState::Zero;
+		nmi_pending = false;
+		nmi_brk7 = true;
+		nmi_brk6e = false;
+		nmi_do = false;
+		nmi_ff1 = true;
+		nmi_ff2 = nmi_prev;
+		nmi_delay1 = false;
+		nmi_delay2 = false;
+		irq_active = inputs[(size_t)InputPad::n_IRQ] == TriState::Zero;
+		poll_history = 0;
+		take_interrupt = Interrupt::None;
+
+		// The beginning of the instruction for the return to the gate-level core
+
+		start_A = A;
+		start_X = X;
+		start_Y = Y;
+		start_S = S;
+		start_P = P;
+		start_nmi = nmi_prev;
+		start_irq = irq_active;
+		instruction_replayable = true;
+		instruction_start_clean = true;
+		LogCycle(inputs, data_bus);
+
+		// Catch up with the gate-level core: the opcode fetch and the second cycle.
+
+		state = State::Fetch;
+		new_instruction = false;
+		Cycle(log[1].data);
+
+		addr = next_addr;
+		write = next_write;
+		sync = next_sync;
+		dor = next_data;
+		Cycle(data_bus);
+	}
+
+	void FastCore::LogCycle(TriState inputs[], uint8_t data)
+	{
+		// Both halves of the cycle see the same pads, except PHI0.
+
+		for (size_t phase = 0; phase < 2; phase++)
+		{
+			LogEntry& entry = log[log_size++];
+			for (size_t n = 0; n < (size_t)InputPad::Max; n++)
+			{
+				entry.inputs[n] = inputs[n];
+			}
+			entry.inputs[(size_t)InputPad::PHI0] = phase ? TriState::One : TriState::Zero;
+			entry.data = data;
+		}
+	}
+
+	bool FastCore::ExitToGate(bool reset)
+	{
+		// With /RES the pads do not have to be quiet: the reset that follows clears the remembered interrupt edges anyway.
+
+		if (!(reset ? instruction_replayable : instruction_start_clean))
+		{
+			return false;
+		}
+
+		// The gate-level core is reset on a virtual bus with the reset vector pointing to the current instruction. The reset sequence does not write, so the bus only has to answer the vector fetch.
+		// /NMI and /IRQ are held at the levels they had before the instruction. They had not changed for a while, and an NMI edge that the gate-level core may see at the beginning is taken by the reset sequence.
+		// An edge on the opcode fetch itself comes with the replay.
+
+		TriState inputs[(size_t)InputPad::Max]{};
+		TriState outputs[(size_t)OutputPad::Max]{};
+		for (size_t n = 0; n < (size_t)InputPad::Max; n++)
+		{
+			inputs[n] = log[0].inputs[n];
+		}
+		inputs[(size_t)InputPad::n_NMI] = start_nmi ? TriState::Zero : TriState::One;
+		inputs[(size_t)InputPad::n_IRQ] = start_irq ? TriState::Zero : TriState::One;
+		inputs[(size_t)InputPad::RDY] = TriState::One;
+
+		const size_t ResetCycles = 8;
+		const size_t MaxCycles = 32;
+		bool vector_fetched = false;
+
+		for (size_t cycle = 0; cycle < MaxCycles && !vector_fetched; cycle++)
+		{
+			uint16_t address = 0;
+			uint8_t value = 0;
+
+			inputs[(size_t)InputPad::n_RES] = cycle < ResetCycles ? TriState::Zero : TriState::One;
+			inputs[(size_t)InputPad::PHI0] = TriState::Zero;
+			core->sim_Gate(inputs, outputs, &address, &value);
+
+			bool read = outputs[(size_t)OutputPad::RnW] == TriState::One;
+			vector_fetched = cycle >= ResetCycles && read && address == 0xfffd;
+
+			if (read && address == 0xfffc)
+			{
+				value = start_PC & 0xff;
+			}
+			else if (read && address == 0xfffd)
+			{
+				value = start_PC >> 8;
+			}
+
+			inputs[(size_t)InputPad::PHI0] = TriState::One;
+			core->sim_Gate(inputs, outputs, &address, &value);
+		}
+
+		// The opcode fetch of the current instruction: load the registers and flags, then replay the instruction with the real pads.
+
+		uint16_t address = 0;
+		uint8_t value = log[0].data;
+
+		if (vector_fetched)
+		{
+			UserRegs regs{};
+			regs.PC = start_PC;
+			regs.A = start_A;
+			regs.X = start_X;
+			regs.Y = start_Y;
+			regs.S = start_S;
+			regs.P = start_P;
+			core->SetGateRegs(regs);
+
+			core->sim_Gate(log[0].inputs, outputs, &address, &value);
+		}
+
+		if (!vector_fetched || outputs[(size_t)OutputPad::SYNC] != TriState::One || address != start_PC)
+		{
+			// The gate-level core is reset again on the next attempt, so the fast engine simply goes on.
+
+			instruction_replayable = false;
+			instruction_start_clean = false;
+			return false;
+		}
+
+		for (size_t n = 1; n < log_size; n++)
+		{
+			value = log[n].data;
+			core->sim_Gate(log[n].inputs, outputs, &address, &value);
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,280 @@
+/*
+ * breakscore - Famicom functional simulator.
+ *
+ * Copyright (C) 2024 org
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Instruction-level 6502 engine (fast mode).
+// It reproduces the bus activity of the gate-level core cycle by cycle (including dummy reads/writes and interrupt polling points), but instead of the decoder and the random logic it uses a table of decoded opcodes.
+// Limitation: the SO pad is ignored. A falling edge of SO while the fast engine is running does not set the V flag (the APU ties SO to 1).
+// Limitation: when RDY stops the dummy read of an unstable store (SHA, SHX, SHY, TAS), the gate-level core may change the high part of the address during the stall (e.g. TAS $FF2C,Y). The fast engine keeps the address of the first stalled cycle.
+
+#pragma once
+
+namespace M6502Core
+{
+	/// <summary>
+	/// The order of bus cycles of the instruction.
+	/// </summary>
+	enum class FastAddrMode : uint8_t
+	{
+		Implied = 0,		// Also Accumulator
+		Immediate,
+		ZeroPage,
+		ZeroPageX,
+		ZeroPageY,
+		Absolute,
+		AbsoluteX,
+		AbsoluteY,
+		IndirectX,
+		IndirectY,
+		Relative,
+		Break,
+		JumpSubroutine,
+		ReturnInterrupt,
+		ReturnSubroutine,
+		Jump,
+		JumpIndirect,
+		Push,
+		Pull,
+		Halt,
+	};
+
+	/// <summary>
+	/// What the instruction does with the operand.
+	/// </summary>
+	enum class FastOp : uint8_t
+	{
+		// Read
+
+		LDA = 0, LDX, LDY, LAX, ADC, SBC, AND, ORA, EOR, CMP, CPX, CPY, BIT, NOP,
+		ANC, ALR, ARR, AXS, LAS, ANE, LXA,
+
+		// Write
+
+		STA, STX, STY, SAX, SHA, SHX, SHY, TAS,
+
+		// Read-Modify-Write
+
+		ASL, LSR, ROL, ROR, INC, DEC, SLO, RLA, SRE, RRA, DCP, ISC,
+
+		// Implied
+
+		TAX, TAY, TXA, TYA, TSX, TXS, INX, INY, DEX, DEY,
+		CLC, SEC, CLI, SEI, CLV, CLD, SED,
+
+		// Branches (the order follows IR[7:6])
+
+		BPL, BMI, BVC, BVS, BCC, BCS, BNE, BEQ,
+
+		// Stack and flow control (the details are given by FastAddrMode)
+
+		PHA, PHP, PLA, PLP, BRK, JSR, RTI, RTS, JMP, KIL,
+	};
+
+	struct FastOpcode
+	{
+		FastAddrMode mode;
+		FastOp op;
+	};
+
+	/// <summary>
+	/// Instruction-level 6502. Works on the same pads as the gate-level core (M6502::sim) and shares the architectural state with it through the hand-off at the instruction boundary.
+	/// </summary>
+	class FastCore
+	{
+		friend M6502;
+
+		M6502* core = nullptr;
+
+		bool BCD_Hack = false;
+		bool HLE_ALU = false;		// The ALU of the gate-level core is simulated at the high level (HLE + BCD hack). ANC and ARR get their flags a bit differently there.
+
+		// Architectural state. The B flag and bit 5 are not stored in P.
+
+		uint8_t A = 0;
+		uint8_t X = 0;
+		uint8_t Y = 0;
+		uint8_t S = 0;
+		uint8_t P = 0;
+		uint16_t PC = 0;
+
+		static const uint8_t C_FLAG = 0x01;
+		static const uint8_t Z_FLAG = 0x02;
+		static const uint8_t I_FLAG = 0x04;
+		static const uint8_t D_FLAG = 0x08;
+		static const uint8_t B_FLAG = 0x10;
+		static const uint8_t U_FLAG = 0x20;
+		static const uint8_t V_FLAG = 0x40;
+		static const uint8_t N_FLAG = 0x80;
+
+		/// <summary>
+		/// The last completed cycle of the instruction. Each state is named after the addressing mode and the number of the cycle (the opcode fetch is cycle 1).
+		/// </summary>
+		enum class State : uint8_t
+		{
+			Fetch = 0,
+			Implied2,
+			Immediate2,
+			ZeroPage2,
+			ZeroPageX2, ZeroPageX3,
+			Absolute2, Absolute3,
+			AbsoluteX2, AbsoluteX3, AbsoluteX4,
+			IndirectX2, IndirectX3, IndirectX4, IndirectX5,
+			IndirectY2, IndirectY3, IndirectY4, IndirectY5,
+			Operand,			// Read instructions: the cycle that reads the operand
+			Store,				// Write instructions: the cycle that writes the result
+			ModifyRead,			// RMW instructions: read the operand
+			ModifyDummy,		// RMW instructions: write back the unmodified value
+			ModifyWrite,		// RMW instructions: write the result
+			Relative2, Relative3, Relative4,
+			Break2, Break3, Break4, Break5, Break6, Break7,
+			JumpSubroutine2, JumpSubroutine3, JumpSubroutine4, JumpSubroutine5, JumpSubroutine6,
+			ReturnInterrupt2, ReturnInterrupt3, ReturnInterrupt4, ReturnInterrupt5, ReturnInterrupt6,
+			ReturnSubroutine2, ReturnSubroutine3, ReturnSubroutine4, ReturnSubroutine5, ReturnSubroutine6,
+			Jump2, Jump3,
+			JumpIndirect2, JumpIndirect3, JumpIndirect4, JumpIndirect5,
+			Push2, Push3,
+			Pull2, Pull3, Pull4,
+			Halt2, Halt3, Halt4,
+			Halt,
+		};
+
+		State state = State::Fetch;
+		FastOpcode opcode{};
+
+		// Bus request for the next cycle. Goes to the pads during PHI1.
+
+		uint16_t next_addr = 0;
+		bool next_write = false;
+		bool next_sync = false;
+		uint8_t next_data = 0;
+
+		// Pads of the current cycle
+
+		uint16_t addr = 0;
+		bool write = false;
+		bool sync = false;
+		uint8_t dor = 0;
+
+		// Address calculation
+
+		uint16_t ea = 0;
+		uint8_t base_lo = 0;
+		uint8_t base_hi = 0;
+		uint8_t data = 0;
+		bool store_stalled = false;		// RDY = 0 on the dummy read of the indexed addressing
+		bool carry_lost = false;		// The same, and the address has wrapped around
+		bool vector_stalled = false;	// RDY = 0 on the fetch of the high byte of the interrupt vector
+
+		// Interrupts
+
+		enum class Interrupt : uint8_t
+		{
+			None = 0,
+			IRQ,
+			NMI,
+		};
+
+		// /NMI is detected by the same latches as in BRKProcessing (nmi_pending = DONMI). The interrupt sequence masks the detection while it pushes P and fetches the vector, and an NMI that has been taken is not detected again until /NMI goes high.
+
+		bool nmi_pending = false;
+		bool nmi_prev = false;			// nmip_latch: /NMI = 0 on the previous cycle
+		bool nmi_brk7 = true;			// brk7_latch
+		bool nmi_brk6e = false;			// brk6e_latch
+		bool nmi_do = false;			// donmi_latch
+		bool nmi_ff1 = true;			// ff1_latch: DONMI is cleared
+		bool nmi_ff2 = false;			// ff2_latch: the NMI has been taken
+		bool nmi_delay1 = false;
+		bool nmi_delay2 = false;
+		bool irq_active = false;
+		uint8_t poll_history = 0;		// bit 0: interrupt request at the end of the current cycle, bit 1: of the previous cycle and so on.
+		Interrupt take_interrupt = Interrupt::None;
+		bool in_interrupt = false;
+
+		// Hand-off to the gate-level core.
+		// The calls made since the beginning of the current instruction are logged so that the gate-level core can catch up with the fast engine in the middle of the instruction.
+
+		struct LogEntry
+		{
+			BaseLogic::TriState inputs[(size_t)InputPad::Max];
+			uint8_t data;
+		};
+
+		static const size_t LogMax = 0x1000;
+		LogEntry log[LogMax]{};
+		size_t log_size = 0;
+		bool new_instruction = false;
+		bool entry_prepared = false;		// PrepareEntry was called on the previous cycle.
+		bool instruction_replayable = false;		// The instruction is not replaced by an interrupt sequence and all its cycles are logged.
+		bool instruction_start_clean = false;		// The same, and the gate-level core can be brought to the beginning of the current instruction.
+		uint8_t start_A = 0;
+		uint8_t start_X = 0;
+		uint8_t start_Y = 0;
+		uint8_t start_S = 0;
+		uint8_t start_P = 0;
+		uint16_t start_PC = 0;
+		bool start_nmi = false;		// /NMI = 0 as the gate-level core saw it before the instruction.
+		bool start_irq = false;		// /IRQ = 0 as the gate-level core saw it before the instruction.
+
+		void Read(uint16_t address);
+		void Write(uint16_t address, uint8_t value);
+		void Fetch();
+		void Access();
+		void EndInstruction(size_t poll_depth);
+		void Cycle(uint8_t value);
+		void LogCycle(BaseLogic::TriState inputs[], uint8_t data);
+		void DetectNMI(bool nmi, bool ready);
+		bool InterruptRequest();
+
+		uint8_t GetIndex();
+		void SetNZ(uint8_t value);
+		void Compare(uint8_t reg, uint8_t value);
+		void Add(uint8_t value);
+		void Subtract(uint8_t value);
+		void ExecuteRead(uint8_t value);
+		uint8_t ExecuteModify(uint8_t value);
+		uint16_t GetIndexedAddress();
+		uint8_t GetStoreValue();
+		void ExecuteImplied();
+		bool BranchTaken();
+
+		static const FastOpcode opcodes[0x100];
+
+	public:
+		FastCore(M6502* parent, bool BCD_Hack);
+		~FastCore();
+
+		void sim(BaseLogic::TriState inputs[], BaseLogic::TriState outputs[], uint16_t* addr_bus, uint8_t* data_bus);
+
+		/// <summary>
+		/// Remember the opcode fetch cycle. Called on PHI2 of the fetch, after the gate-level core has simulated it.
+		/// </summary>
+		void PrepareEntry(BaseLogic::TriState inputs[], uint16_t fetch_addr, uint8_t fetch_data);
+
+		/// <summary>
+		/// Take over from the gate-level core. Called on PHI2 of the cycle following PrepareEntry, after the gate-level core has simulated it.
+		/// </summary>
+		void EnterFromGate(BaseLogic::TriState inputs[], uint8_t data_bus);
+
+		/// <summary>
+		/// Bring the gate-level core to the current position in the instruction: the core is reset to the beginning of the instruction, the registers and flags are loaded and the cycles logged since then are replayed.
+		/// </summary>
+		/// <param name="reset">true: /RES = 0, the gate-level core is reset right after the hand-off</param>
+		/// <returns>false: the hand-off is not possible in this instruction (the pads have changed recently or the instruction is replaced by an interrupt), the fast engine keeps running.</returns>
+		bool ExitToGate(bool reset);
+	};
+}
@@ -0,0 +1,229 @@
+/*
+ * breakscore - Famicom functional simulator.
+ *
+ * Copyright (C) 2024 org
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Instruction trace of the 6502 core.
+
+#include "pch.h"
+
+using namespace BaseLogic;
+
+namespace M6502Core
+{
+	Tracer::Tracer(M6502* parent, size_t entries)
+	{
+		core = parent;
+		ring_size = entries;
+		ring = new TraceRecord[ring_size];
+		memset(ring, 0, ring_size * sizeof(TraceRecord));
+	}
+
+	Tracer::~Tracer()
+	{
+		SetSink(nullptr, 0);
+		delete[] ring;
+	}
+
+	void Tracer::sim(TriState outputs[], uint16_t addr_bus, uint8_t data_bus)
+	{
+		bool read = outputs[(size_t)OutputPad::RnW] == TriState::One;
+
+		if (outputs[(size_t)OutputPad::SYNC] == TriState::One)
+		{
+			// The opcode fetch can be repeated while RDY = 0; the record is started again in that case.
+
+			if (current_open && current_cycle != 0)
+			{
+				Complete();
+			}
+
+			current = {};
+			current.cycle = cycle;
+			current.PC = addr_bus;
+			current.bytes[0] = data_bus;
+			current.length = (uint8_t)GetLength(data_bus);
+			current_cycle = 0;
+			current_open = true;
+			last_operand = false;
+		}
+		else if (current_open)
+		{
+			current_cycle++;
+
+			// The registers are taken on the second cycle: by then the previous instruction has written back its result.
+
+			if (current_cycle == 1)
+			{
+				UserRegs regs{};
+				core->GetUserRegs(regs);
+				current.A = regs.A;
+				current.X = regs.X;
+				current.Y = regs.Y;
+				current.S = regs.S;
+				current.P = regs.P;
+			}
+
+			// The operands are the first reads from PC+1 and PC+2 (JSR reads PC+2 on the last cycle).
+
+			if (read)
+			{
+				if (current_cycle == 1 && addr_bus == (uint16_t)(current.PC + 1))
+				{
+					current.bytes[1] = data_bus;
+				}
+				else if (!last_operand && addr_bus == (uint16_t)(current.PC + 2) && current.length == 3)
+				{
+					current.bytes[2] = data_bus;
+					last_operand = true;
+				}
+			}
+		}
+
+		cycle++;
+	}
+
+	void Tracer::Complete()
+	{
+		ring[total % ring_size] = current;
+		total++;
+		current_open = false;
+
+		if (sink != nullptr)
+		{
+			fwrite(&current, sizeof(TraceRecord), 1, sink);
+			since_flush++;
+			if (flush_interval != 0 && since_flush >= flush_interval)
+			{
+				fflush(sink);
+				since_flush = 0;
+			}
+		}
+	}
+
+	size_t Tracer::GetRecords(TraceRecord* records, size_t count)
+	{
+		size_t available = total < ring_size ? total : ring_size;
+		if (count > available)
+		{
+			count = available;
+		}
+
+		size_t first = total - count;
+		for (size_t n = 0; n < count; n++)
+		{
+			records[n] = ring[(first + n) % ring_size];
+		}
+
+		return count;
+	}
+
+	void Tracer::Dump(FILE* f, size_t count)
+	{
+		size_t available = total < ring_size ? total : ring_size;
+		if (count > available)
+		{
+			count = available;
+		}
+
+		char text[0x80];
+		size_t first = total - count;
+		for (size_t n = 0; n < count; n++)
+		{
+			Decode(ring[(first + n) % ring_size], text, sizeof(text));
+			fprintf(f, "%s\n", text);
+		}
+	}
+
+	bool Tracer::SetSink(const char* filename, size_t interval)
+	{
+		if (sink != nullptr)
+		{
+			fclose(sink);
+			sink = nullptr;
+		}
+
+		flush_interval = interval;
+		since_flush = 0;
+
+		if (filename == nullptr)
+		{
+			return true;
+		}
+
+		sink = fopen(filename, "wb");
+		return sink != nullptr;
+	}
+
+	size_t Tracer::GetLength(uint8_t opcode)
+	{
+		// The opcode is aaabbbcc, bbb selects the addressing mode.
+
+		size_t aaa = opcode >> 5;
+		size_t bbb = (opcode >> 2) & 7;
+		size_t cc = opcode & 3;
+
+		switch (bbb)
+		{
+			case 0:
+				if (opcode == 0x20)
+				{
+					return 3;		// JSR
+				}
+				if (cc == 1 || cc == 3)
+				{
+					return 2;		// (zp,X)
+				}
+				return aaa >= 4 ? 2 : 1;		// #imm or BRK/RTI/RTS/KIL
+			case 1:
+			case 5:
+				return 2;		// zp, zp,X
+			case 2:
+				return (cc == 1 || cc == 3) ? 2 : 1;		// #imm or implied
+			case 3:
+			case 7:
+				return 3;		// abs, abs,X
+			case 4:
+				return cc == 2 ? 1 : 2;		// KIL or branch, (zp),Y
+			case 6:
+				return (cc == 1 || cc == 3) ? 3 : 1;		// abs,Y or implied
+		}
+
+		return 1;
+	}
+
+	void Tracer::Decode(const TraceRecord& rec, char* text, size_t maxlen)
+	{
+		char bytes[0x10];
+
+		switch (rec.length)
+		{
+			case 1:
+				snprintf(bytes, sizeof(bytes), "%02X      ", rec.bytes[0]);
+				break;
+			case 2:
+				snprintf(bytes, sizeof(bytes), "%02X %02X   ", rec.bytes[0], rec.bytes[1]);
+				break;
+			default:
+				snprintf(bytes, sizeof(bytes), "%02X %02X %02X", rec.bytes[0], rec.bytes[1], rec.bytes[2]);
+				break;
+		}
+
+		snprintf(text, maxlen, "%04X  %s  A:%02X X:%02X Y:%02X P:%02X SP:%02X CYC:%llu",
+			rec.PC, bytes, rec.A, rec.X, rec.Y, rec.P, rec.S, (unsigned long long)rec.cycle);
+	}
+}
@@ -0,0 +1,105 @@
+/*
+ * breakscore - Famicom functional simulator.
+ *
+ * Copyright (C) 2024 org
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Instruction trace of the 6502 core.
+// The trace is collected from the pads (SYNC, address and data bus), so it works the same for the gate-level core and the fast engine.
+
+#pragma once
+
+namespace M6502Core
+{
+	/// <summary>
+	/// One record per instruction (opcode fetch).
+	/// </summary>
+	struct TraceRecord
+	{
+		uint64_t cycle;			// Number of the CPU cycle of the opcode fetch, counted since the trace was enabled
+		uint16_t PC;			// Address of the opcode fetch (SYNC = 1)
+		uint8_t bytes[3];		// Opcode and operands
+		uint8_t length;			// Length of the instruction in bytes
+		uint8_t A;
+		uint8_t X;
+		uint8_t Y;
+		uint8_t S;
+		uint8_t P;				// As PHP would push it, but without the B flag
+	};
+
+	/// <summary>
+	/// Ring buffer of the last executed instructions with an optional file sink.
+	/// </summary>
+	class Tracer
+	{
+		M6502* core = nullptr;
+
+		TraceRecord* ring = nullptr;
+		size_t ring_size = 0;
+		size_t total = 0;			// Number of completed records
+
+		TraceRecord current{};
+		size_t current_cycle = 0;		// The cycle of the current instruction (0: opcode fetch)
+		bool current_open = false;
+		bool last_operand = false;		// The third byte of the instruction has been read
+		uint64_t cycle = 0;
+
+		FILE* sink = nullptr;
+		size_t flush_interval = 0;
+		size_t since_flush = 0;
+
+		void Complete();
+
+	public:
+		Tracer(M6502* parent, size_t entries);
+		~Tracer();
+
+		/// <summary>
+		/// Called by M6502::sim at PHI2, when the pads are settled.
+		/// </summary>
+		void sim(BaseLogic::TriState outputs[], uint16_t addr_bus, uint8_t data_bus);
+
+		/// <summary>
+		/// Copy the last records (oldest first).
+		/// </summary>
+		/// <param name="records">Destination</param>
+		/// <param name="count">Maximum number of records</param>
+		/// <returns>Number of records copied</returns>
+		size_t GetRecords(TraceRecord* records, size_t count);
+
+		/// <summary>
+		/// Print the last records as text, one instruction per line.
+		/// </summary>
+		void Dump(FILE* f, size_t count);
+
+		/// <summary>
+		/// Also write each completed record to a binary file. The file is flushed every `flush_interval` records (0: only when closed).
+		/// </summary>
+		/// <param name="filename">nullptr: close the sink</param>
+		/// <returns>false: the file could not be created</returns>
+		bool SetSink(const char* filename, size_t flush_interval);
+
+		/// <summary>
+		/// Get the length of the instruction in bytes.
+		/// </summary>
+		static size_t GetLength(uint8_t opcode);
+
+		/// <summary>
+		/// Convert a record to text (nestest log style).
+		/// </summary>
+		static void Decode(const TraceRecord& rec, char* text, size_t maxlen);
+	};
+}
@@ -66,6 +66,17 @@ namespace Mappers
 		return valid;
 	}
 
+	bool AOROM::GetPPUMemoryMap(PPUMemoryMap& map)
+	{
+		for (size_t n = 0; n < 8; n++)
+		{
+			map.chr[n] = &CHR[n * 0x400];
+			map.chr_writable[n] = true;
+			map.vram_a10[n] = vram_a10 == TriState::One ? 1 : 0;
+		}
+		return true;
+	}
+
 	void AOROM::sim(
 		TriState cart_in[(size_t)CartInput::Max],
 		TriState cart_out[(size_t)CartOutput::Max],
@@ -98,6 +109,14 @@ namespace Mappers
 
 		counter.sim(nROMSEL, vdd, CPU_RnW, gnd, gnd, P, RCO, Q);
 
+		// Single-screen mirroring switch changes the PPU memory map
+
+		if (Q[3] != vram_a10)
+		{
+			vram_a10 = Q[3];
+			ppu_map_version++;
+		}
+
 		// PPU Part
 
 		TriState nRD = cart_in[(size_t)CartInput::nRD];
@@ -34,6 +34,7 @@ namespace Mappers
 		size_t CHRSize = 0;
 
 		BaseBoard::LS161 counter{};
+		BaseLogic::TriState vram_a10 = BaseLogic::TriState::X;		// Last Q[3] (VRAM_A10)
 
 	public:
 		AOROM(ConnectorType p1, uint8_t* nesImage, size_t nesImageSize);
@@ -52,5 +53,7 @@ namespace Mappers
 			CartAudioOutSignal* snd_out,
 			// NES only
 			uint16_t* exp, bool& exp_dirty);
+
+		bool GetPPUMemoryMap(PPUMemoryMap& map) override;
 	};
 }
\ No newline at end of file
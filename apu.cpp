@@ -198,6 +198,104 @@ namespace APUSim
 		transp_latch.set(val, TriState::One);
 	}
 
+	void PackedRegister::sim(TriState ACLK1, TriState Enable, uint32_t val, uint32_t mask, TriState Res)
+	{
+		if (Res == TriState::One)
+		{
+			value &= ~mask;
+		}
+		else if (ACLK1 == TriState::Zero && Enable == TriState::One)
+		{
+			value = (value & ~mask) | (val & mask);
+		}
+	}
+
+	uint32_t PackedRegister::get()
+	{
+		return value;
+	}
+
+	PackedCounter::PackedCounter(size_t bits)
+	{
+		mask = (1 << bits) - 1;
+		// The cg_latch is 0 at power-up, so the first Step loads all ones.
+		next = mask;
+	}
+
+	TriState PackedCounter::sim(TriState Carry, TriState Dec, TriState Clear, TriState Load, TriState Step, TriState ACLK1, uint32_t val)
+	{
+		if (Load == TriState::One)
+		{
+			value = val & mask;
+		}
+		else if (Clear == TriState::One)
+		{
+			value = 0;
+		}
+		else if (Step == TriState::One)
+		{
+			value = next;
+		}
+
+		// The carry chain of the bits is an increment/decrement of the whole value.
+
+		bool carry = Carry == TriState::One;
+		bool down = Dec == TriState::One;
+
+		if (ACLK1 == TriState::One)
+		{
+			next = carry ? ((down ? value - 1 : value + 1) & mask) : value;
+		}
+
+		bool cout = carry && value == (down ? 0 : mask);
+		return cout ? TriState::One : TriState::Zero;
+	}
+
+	uint32_t PackedCounter::get()
+	{
+		return value;
+	}
+
+	PackedLFSR::PackedLFSR(size_t bits)
+	{
+		mask = (1 << bits) - 1;
+		msb = bits - 1;
+		// The out_latch is 0 at power-up, its inverted output is 1.
+		sout = mask;
+	}
+
+	void PackedLFSR::sim(TriState ACLK1, TriState load, TriState step, uint32_t val, TriState shift_in)
+	{
+		uint32_t sin = shift_in == TriState::One ? 1 : 0;
+
+		if (load == TriState::One)
+		{
+			in = val & mask;
+		}
+		else if (step == TriState::One)
+		{
+			if (ACLK1 == TriState::One)
+			{
+				// Both latches of each bit are open: the input passes through the whole chain.
+				in = sin != 0 ? mask : 0;
+			}
+			else
+			{
+				in = (sout >> 1) | (sin << msb);
+			}
+		}
+
+		if (ACLK1 == TriState::One)
+		{
+			sout = in;
+		}
+	}
+
+	uint32_t PackedLFSR::get_sout()
+	{
+		return sout;
+	}
+
 	// Timing Generator
 
 	CLKGen::CLKGen(APU* parent)
@@ -296,6 +394,12 @@ namespace APUSim
 
 	void CLKGen::sim_SoftCLK_PLA()
 	{
+		if (apu->HLE)
+		{
+			sim_SoftCLK_PLAHLE();
+			return;
+		}
+
 		BaseLogic::TriState s[15]{};
 		BaseLogic::TriState ns[15]{};
 
@@ -315,6 +419,12 @@ namespace APUSim
 
 	void CLKGen::sim_SoftCLK_LFSR()
 	{
+		if (apu->HLE)
+		{
+			sim_SoftCLK_LFSRHLE();
+			return;
+		}
+
 		TriState ACLK1 = apu->wire.ACLK1;
 
 		// Feedback
@@ -348,6 +458,62 @@ namespace APUSim
 		return out_latch.get();
 	}
 
+	// Each PLA line matches all 15 bits of the LFSR, so the decoder is a comparison with a constant.
+
+	const uint32_t CLKGen::PLA_Match[5] = { 0x1061, 0x3603, 0x2cd3, 0x0a1f, 0x7185 };
+
+	void CLKGen::sim_SoftCLK_PLAHLE()
+	{
+		for (size_t n = 0; n < 5; n++)
+		{
+			pla[n] = lfsr_sout == PLA_Match[n] ? TriState::One : TriState::Zero;
+		}
+
+		if (mode == TriState::One)
+		{
+			pla[3] = TriState::Zero;
+		}
+
+		pla[5] = lfsr_sout == 0 ? TriState::One : TriState::Zero;
+	}
+
+	void CLKGen::sim_SoftCLK_LFSRHLE()
+	{
+		TriState ACLK1 = apu->wire.ACLK1;
+
+		// Feedback
+
+		TriState C13 = (lfsr_sout & 0x2000) != 0 ? TriState::One : TriState::Zero;
+		TriState C14 = (lfsr_sout & 0x4000) != 0 ? TriState::One : TriState::Zero;
+		shift_in = NOR(AND(C13, C14), NOR3(C13, C14, pla[5]));
+
+		// SR15: F2 shifts towards the msb, F1 reloads all ones
+
+		uint32_t sin = shift_in == TriState::One ? 1 : 0;
+
+		if (F2 == TriState::One)
+		{
+			if (ACLK1 == TriState::One)
+			{
+				// Both latches of each bit are open: the input passes through the whole chain.
+				lfsr_in = sin != 0 ? 0x7fff : 0;
+			}
+			else
+			{
+				lfsr_in = ((lfsr_sout << 1) | sin) & 0x7fff;
+			}
+		}
+		else if (F1 == TriState::One)
+		{
+			lfsr_in = 0x7fff;
+		}
+
+		if (ACLK1 == TriState::One)
+		{
+			lfsr_sout = lfsr_in;
+		}
+	}
+
 	TriState CLKGen::GetINTFF()
 	{
 		return int_ff.get();
@@ -368,7 +534,29 @@ namespace APUSim
 	{
 		sim_DividerBeforeCore();
 
-		if (apu->wire.PHI0 != apu->PrevPHI_Core)
+#if _DEBUG
+		if (apu->leader != nullptr)
+		{
+			if (apu->wire.PHI0 != apu->PrevPHI_Core)
+			{
+				sim_FollowCore();
+				apu->PrevPHI_Core = apu->wire.PHI0;
+			}
+
+			sim_DividerAfterCore();
+			return;
+		}
+#endif
+
+		if (apu->core_idle)
+		{
+			if (apu->wire.PHI0 != apu->PrevPHI_Core)
+			{
+				sim_IdleCore();
+				apu->PrevPHI_Core = apu->wire.PHI0;
+			}
+		}
+		else if (apu->wire.PHI0 != apu->PrevPHI_Core)
 		{
 			TriState inputs[(size_t)M6502Core::InputPad::Max]{};
 			TriState outputs[(size_t)M6502Core::OutputPad::Max];
@@ -390,11 +578,71 @@ namespace APUSim
 			apu->wire.SYNC = outputs[(size_t)M6502Core::OutputPad::SYNC];
 
 			apu->PrevPHI_Core = apu->wire.PHI0;
+
+			if (apu->write_log != nullptr && apu->wire.PHI0 == TriState::One)
+			{
+				apu->sim_WriteLog();
+			}
 		}
 
+#if _DEBUG
+		apu->core_DB = apu->DB;
+#endif
+
 		sim_DividerAfterCore();
 	}
 
+	void CoreBinding::sim_FollowCore()
+	{
+		// The lockstep APU: the core outputs are taken from the leading APU, which has already been simulated for this half cycle.
+
+		APU* leader = apu->leader;
+
+		apu->wire.PHI1 = leader->wire.PHI1;
+		apu->wire.PHI2 = leader->wire.PHI2;
+		apu->wire.RnW = leader->wire.RnW;
+		apu->wire.SYNC = leader->wire.SYNC;
+		apu->CPU_Addr = leader->CPU_Addr;
+		apu->DB = leader->core_DB;
+	}
+
+	void CoreBinding::sim_IdleCore()
+	{
+		apu->wire.PHI1 = NOT(apu->wire.PHI0);
+		apu->wire.PHI2 = apu->wire.PHI0;
+		apu->wire.SYNC = TriState::Zero;
+
+		if (apu->wire.PHI0 == TriState::Zero)
+		{
+			// PHI1: the address and R/W of the new cycle. The PHI counter has already been advanced.
+
+			apu->replay_active = apu->replay != nullptr && apu->replay_pos < apu->replay_count && apu->phi_counter >= apu->replay_phi;
+
+			if (apu->replay_active)
+			{
+				apu->CPU_Addr = 0x4000 | apu->replay[apu->replay_pos].reg;
+				apu->wire.RnW = TriState::Zero;
+			}
+			else
+			{
+				apu->CPU_Addr = APU::IdleCoreAddr;
+				apu->wire.RnW = TriState::One;
+			}
+		}
+		else if (apu->replay_active)
+		{
+			// PHI2: the value goes to the data bus, the register decoder makes the write strobe.
+
+			apu->DB = apu->replay[apu->replay_pos].value;
+			apu->replay_pos++;
+
+			if (apu->replay_pos < apu->replay_count)
+			{
+				apu->replay_phi += apu->replay[apu->replay_pos].delta;
+			}
+		}
+	}
+
 	void CoreBinding::sim_DividerBeforeCore()
 	{
 		TriState n_CLK = apu->wire.n_CLK;
@@ -533,6 +781,33 @@ namespace APUSim
 		sprdma_rdy = NOR(NOT(NOSPR), StartDMA.get());
 		apu->wire.RDY = AND(sprdma_rdy, DMCRDY);
 
+#if APU_DMA_STATS
+		// Halted cycles are counted once per PHI cycle, during PHI2. On a write cycle the core does not stop, so only reads are counted.
+
+		if (apu->wire.PHI2 == TriState::One && stats_phi != apu->phi_counter)
+		{
+			stats_phi = apu->phi_counter;
+
+			if (RnW == TriState::One)
+			{
+				if (sprdma_rdy == TriState::Zero)
+				{
+					apu->dma_stats.spr_halt_cycles++;
+				}
+				else if (DMCRDY == TriState::Zero)
+				{
+					apu->dma_stats.dmc_halt_cycles++;
+				}
+			}
+		}
+
+		if (IsNegedge(stats_nospr, NOSPR))
+		{
+			apu->dma_stats.spr_dma_starts++;
+		}
+		stats_nospr = NOSPR;
+#endif
+
 		apu->wire.SPR_PPU = NOR3(NOSPR, RUNDMC, NOT(DMADirToggle.get()));
 		apu->wire.SPR_CPU = NOR3(NOSPR, RUNDMC, DMADirToggle.get());
 	}
@@ -599,6 +874,12 @@ namespace APUSim
 	{
 		ACLK2 = NOT(apu->wire.nACLK2);
 
+		if (apu->HLE)
+		{
+			sim_HLE();
+			return;
+		}
+
 		sim_SampleCounterReg();
 
 		sim_ControlReg();
@@ -653,6 +934,14 @@ namespace APUSim
 		int_ff.set(NOR4(NOR(int_ff.get(), AssertInt), W4015, n_IRQEN, RES));
 		apu->SetDBBit(7, NOT(n_R4015) == TriState::One ? NOT(int_ff.nget()) : TriState::Z);
 		apu->wire.DMCINT = NOR(int_ff.nget(), n_IRQEN);
+
+#if APU_DMA_STATS
+		if (IsPosedge(stats_int, apu->wire.DMCINT))
+		{
+			apu->dma_stats.dmc_irqs++;
+		}
+		stats_int = apu->wire.DMCINT;
+#endif
 	}
 
 	void DpcmChan::sim_EnableControl()
@@ -689,6 +978,16 @@ namespace APUSim
 		apu->wire.RUNDMC = run_latch2.nget();
 		apu->wire.n_DMC_AB = rdy_ff.get();
 		apu->wire.DMCRDY = NOR(start_ff.get(), rdy_ff.nget());
+
+#if APU_DMA_STATS
+		// Each fetch takes the address bus (n_DMC_AB = 0) for one cycle.
+
+		if (IsNegedge(stats_dmc_ab, apu->wire.n_DMC_AB))
+		{
+			apu->dma_stats.dmc_dma_starts++;
+		}
+		stats_dmc_ab = apu->wire.n_DMC_AB;
+#endif
 	}
 
 	void DpcmChan::sim_SampleCounterControl()
@@ -993,6 +1292,120 @@ namespace APUSim
 
 #pragma endregion "DPCM Addressing & Output"
 
+#pragma region "DPCM HLE"
+
+	const uint16_t DpcmChan::FreqTable[16] = {
+		0x173, 0x08a, 0x143, 0x0db, 0x1ee, 0x03f, 0x07d, 0x1d1,
+		0x009, 0x0dc, 0x0f1, 0x0f9, 0x08d, 0x189, 0x18e, 0x156,
+	};
+
+	void DpcmChan::sim_HLE()
+	{
+		// The same order as the gate-level simulation: the control circuits put the $4015 bits on the DB, so the registers that follow see them.
+
+		TriState ACLK1 = apu->wire.ACLK1;
+		TriState RES = apu->wire.RES;
+
+		scnt_reg_hle.sim(ACLK1, apu->wire.W4013, apu->DB, 0xff);
+
+		ctrl_reg_hle.sim(ACLK1, apu->wire.W4010, apu->DB, 0xcf);
+		LOOPMode = (ctrl_reg_hle.get() & 0x40) != 0 ? TriState::One : TriState::Zero;
+		n_IRQEN = (ctrl_reg_hle.get() & 0x80) != 0 ? TriState::Zero : TriState::One;
+
+		sim_FreqLFSRHLE();
+
+		sim_IntControl();
+		sim_EnableControl();
+		sim_DMAControl();
+
+		sim_SampleCounterControl();
+		SOUT = scnt_hle.sim(TriState::One, TriState::One, RES, DSLOAD, DSSTEP, ACLK1, scnt_reg_hle.get() << 4);
+		nout_latch.set(sbcnt_hle.sim(TriState::One, TriState::Zero, RES, RES, NSTEP, ACLK1, 0), ACLK1);
+		n_NOUT = nout_latch.nget();
+
+		sim_SampleBufferControl();
+		sim_SampleBufferHLE();
+
+		// The address counter is 15 bits (addr_lo + addr_hi), the register goes to bits 6-13 and the bit 14 is loaded with 1.
+
+		addr_reg_hle.sim(ACLK1, apu->wire.W4012, apu->DB, 0xff);
+		addr_cnt_hle.sim(TriState::One, TriState::Zero, RES, DSLOAD, DSSTEP, ACLK1, (addr_reg_hle.get() << 6) | 0x4000);
+		apu->DMC_Addr = (uint16_t)(addr_cnt_hle.get() | 0x8000);
+
+		sim_OutputHLE();
+	}
+
+	void DpcmChan::sim_FreqLFSRHLE()
+	{
+		TriState ACLK1 = apu->wire.ACLK1;
+		TriState RES = apu->wire.RES;
+
+		uint32_t sout = lfsr_hle.get_sout();
+		TriState sout0 = (sout & 0x01) != 0 ? TriState::One : TriState::Zero;
+		TriState sout4 = (sout & 0x10) != 0 ? TriState::One : TriState::Zero;
+
+		TriState nor1_out = sout == 0 ? TriState::One : TriState::Zero;
+		TriState nor2_out = sout == 1 ? TriState::One : TriState::Zero;
+
+		TriState feedback = NOR3(AND(sout0, sout4), RES, NOR3(sout0, sout4, nor1_out));
+		TriState nor3_out = NOR(RES, NOT(nor2_out));
+		DFLOAD = NOR(NOT(ACLK2), NOT(nor3_out));
+		TriState DFSTEP = NOR(NOT(ACLK2), nor3_out);
+
+		lfsr_hle.sim(ACLK1, DFLOAD, DFSTEP, FreqTable[ctrl_reg_hle.get() & 0xf], feedback);
+	}
+
+	void DpcmChan::sim_SampleBufferHLE()
+	{
+		TriState ACLK1 = apu->wire.ACLK1;
+		TriState RES = apu->wire.RES;
+
+		buf_reg_hle.sim(ACLK1, PCM, apu->DB, 0xff);
+
+		// The out_latch of the shift register bits holds the inverted value, the in_latch holds the output of the next bit (the msb gets 0).
+
+		if (RES == TriState::One)
+		{
+			shift_out_hle = 0;
+		}
+		else if (BLOAD == TriState::One)
+		{
+			shift_out_hle = ~buf_reg_hle.get() & 0xff;
+		}
+		else if (BSTEP == TriState::One)
+		{
+			// If ACLK1 is also active, the shifted-in 0 passes through all bits.
+			shift_out_hle = ACLK1 == TriState::One ? 0xff : (~shift_in_hle & 0xff);
+		}
+
+		if (ACLK1 == TriState::One)
+		{
+			shift_in_hle = (~shift_out_hle & 0xff) >> 1;
+		}
+
+		n_BOUT = (shift_out_hle & 1) != 0 ? TriState::One : TriState::Zero;
+	}
+
+	void DpcmChan::sim_OutputHLE()
+	{
+		TriState ACLK1 = apu->wire.ACLK1;
+		TriState RES = apu->wire.RES;
+		TriState W4011 = apu->wire.W4011;
+
+		DOUT = out_cnt_hle.sim(TriState::One, n_BOUT, RES, W4011, DSTEP, ACLK1, apu->DB >> 1);
+
+		out_reg.sim(ACLK1, W4011, apu->GetDBBit(0));
+
+		uint32_t out = out_cnt_hle.get();
+		apu->DMC_Out[0] = out_reg.get();
+		for (size_t n = 0; n < 6; n++)
+		{
+			apu->DMC_Out[n + 1] = ((out >> n) & 1) != 0 ? TriState::One : TriState::Zero;
+		}
+	}
+
+#pragma endregion "DPCM HLE"
+
 	// Length Counters
 
 	LengthCounter::LengthCounter(APU* parent)
@@ -1004,11 +1417,24 @@ namespace APUSim
 	{
 	}
 
+	const uint8_t LengthCounter::LengthTable[32] = {
+		0x09, 0xfd, 0x13, 0x01, 0x27, 0x03, 0x4f, 0x05, 0x9f, 0x07, 0x3b, 0x09, 0x0d, 0x0b, 0x19, 0x0d,
+		0x0b, 0x0f, 0x17, 0x11, 0x2f, 0x13, 0x5f, 0x15, 0xbf, 0x17, 0x47, 0x19, 0x0f, 0x1b, 0x1f, 0x1d,
+	};
+
 	void LengthCounter::sim(size_t bit_ena, TriState WriteEn, TriState LC_CarryIn, TriState& LC_NoCount)
 	{
-		sim_Decoder1();
-		sim_Decoder2();
-		sim_Counter(LC_CarryIn, WriteEn);
+		if (apu->HLE)
+		{
+			// The decoder latches are transparent, so the decoder is just a lookup of DB[7:3].
+			carry_out = cnt_hle.sim(LC_CarryIn, TriState::One, apu->wire.RES, WriteEn, STEP, apu->wire.ACLK1, LengthTable[apu->DB >> 3]);
+		}
+		else
+		{
+			sim_Decoder1();
+			sim_Decoder2();
+			sim_Counter(LC_CarryIn, WriteEn);
+		}
 		sim_Control(bit_ena, WriteEn, LC_NoCount);
 	}
 
@@ -1162,6 +1588,12 @@ namespace APUSim
 
 	void EnvelopeUnit::sim(TriState V[4], TriState WR_Reg, TriState WR_LC)
 	{
+		if (apu->HLE)
+		{
+			sim_HLE(V, WR_Reg, WR_LC);
+			return;
+		}
+
 		TriState ACLK1 = apu->wire.ACLK1;
 		TriState n_LFO1 = apu->wire.n_LFO1;
 		TriState RES = apu->wire.RES;
@@ -1206,31 +1638,82 @@ namespace APUSim
 		}
 	}
 
-	TriState EnvelopeUnit::get_LC()
+	void EnvelopeUnit::sim_HLE(TriState V[4], TriState WR_Reg, TriState WR_LC)
 	{
-		return lc_reg.nget();
-	}
-
-	// Noise Channel
+		TriState ACLK1 = apu->wire.ACLK1;
+		TriState n_LFO1 = apu->wire.n_LFO1;
+		TriState RES = apu->wire.RES;
 
-	NoiseChan::NoiseChan(APU* parent)
-	{
-		apu = parent;
-		env_unit = new EnvelopeUnit(apu);
-	}
+		// Controls
 
-	NoiseChan::~NoiseChan()
-	{
+		TriState RLOAD = NOR(n_LFO1, rco_latch.get());
+		TriState RSTEP = NOR(n_LFO1, rco_latch.nget());
+		TriState EIN = NAND(eco_latch.get(), get_LC());
+		TriState eco_reload = NOR(eco_latch.get(), reload_latch.get());
+		TriState ESTEP = NOR(NOT(RLOAD), NOT(eco_reload));
+		TriState ERES = NOR(NOT(RLOAD), eco_reload);
+
+		// Reg/counters
+
+		reg_hle.sim(ACLK1, WR_Reg, apu->DB, 0x3f);
+		uint32_t reg = reg_hle.get();
+
+		TriState RCO = decay_cnt_hle.sim(TriState::One, TriState::One, RES, RLOAD, RSTEP, ACLK1, reg & 0xf);
+		TriState ECO = env_cnt_hle.sim(TriState::One, TriState::One, RES, ERES, ESTEP, ACLK1, EIN == TriState::One ? 0xf : 0);
+
+		EnvReload.set(NOR(NOR(EnvReload.get(), NOR(n_LFO1, erld_latch.get())), WR_LC));
+		TriState RELOAD = EnvReload.nget();
+
+		erld_latch.set(EnvReload.get(), ACLK1);
+		reload_latch.set(RELOAD, ACLK1);
+		rco_latch.set(NOR(RCO, RELOAD), ACLK1);
+		eco_latch.set(AND(ECO, NOT(RELOAD)), ACLK1);
+
+		uint32_t vol = (reg & 0x10) != 0 ? reg : env_cnt_hle.get();
+		for (size_t n = 0; n < 4; n++)
+		{
+			V[n] = ((vol >> n) & 1) != 0 ? TriState::One : TriState::Zero;
+		}
+	}
+
+	TriState EnvelopeUnit::get_LC()
+	{
+		if (apu->HLE)
+		{
+			return (reg_hle.get() & 0x20) != 0 ? TriState::Zero : TriState::One;
+		}
+		return lc_reg.nget();
+	}
+
+	// Noise Channel
+
+	NoiseChan::NoiseChan(APU* parent)
+	{
+		apu = parent;
+		env_unit = new EnvelopeUnit(apu);
+	}
+
+	NoiseChan::~NoiseChan()
+	{
 		delete env_unit;
 	}
 
 	void NoiseChan::sim()
 	{
-		sim_FreqReg();
-		sim_Decoder1();
-		sim_Decoder2();
-		sim_FreqLFSR();
-		sim_RandomLFSR();
+		if (apu->HLE)
+		{
+			freq_reg_hle.sim(apu->wire.ACLK1, apu->wire.W400E, apu->DB, 0xf, apu->wire.RES);
+			sim_FreqLFSRHLE();
+			sim_RandomLFSRHLE();
+		}
+		else
+		{
+			sim_FreqReg();
+			sim_Decoder1();
+			sim_Decoder2();
+			sim_FreqLFSR();
+			sim_RandomLFSR();
+		}
 
 		env_unit->sim(Vol, apu->wire.W400C, apu->wire.W400F);
 		for (size_t n = 0; n < 4; n++)
@@ -1239,6 +1722,22 @@ namespace APUSim
 		}
 	}
 
+	void NoiseChan::sim_Idle()
+	{
+		// The LFSRs run while the channel is silenced. The frequency register, the decoder and the envelope do not change.
+
+		if (apu->HLE)
+		{
+			sim_FreqLFSRHLE();
+			sim_RandomLFSRHLE();
+		}
+		else
+		{
+			sim_FreqLFSR();
+			sim_RandomLFSR();
+		}
+	}
+
 	void NoiseChan::sim_FreqReg()
 	{
 		TriState ACLK1 = apu->wire.ACLK1;
@@ -1391,6 +1890,63 @@ namespace APUSim
 		return env_unit->get_LC();
 	}
 
+	const uint16_t NoiseChan::FreqTable[16] = {
+		0x002, 0x00a, 0x0aa, 0x2bb, 0x139, 0x173, 0x063, 0x067,
+		0x1a9, 0x106, 0x227, 0x062, 0x642, 0x20f, 0x300, 0x140,
+	};
+
+	void NoiseChan::sim_FreqLFSRHLE()
+	{
+		TriState nACLK2 = apu->wire.nACLK2;
+		TriState ACLK1 = apu->wire.ACLK1;
+		TriState RES = apu->wire.RES;
+		TriState ACLK4 = NOT(nACLK2);
+
+		uint32_t sout = freq_lfsr_hle.get_sout();
+		TriState sout0 = (sout & 0x01) != 0 ? TriState::One : TriState::Zero;
+		TriState sout2 = (sout & 0x04) != 0 ? TriState::One : TriState::Zero;
+
+		TriState NFZ = sout == 0 ? TriState::One : TriState::Zero;
+		TriState NFOUT = sout == 1 ? TriState::One : TriState::Zero;
+		TriState step_load = NOR(NOT(NFOUT), RES);
+		TriState NFLOAD = NOR(NOT(ACLK4), NOT(step_load));
+		TriState NFSTEP = NOR(NOT(ACLK4), step_load);
+		TriState NSIN = NOR3(AND(sout0, sout2), NOR3(sout0, sout2, NFZ), RES);
+		RSTEP = NFLOAD;
+
+		freq_lfsr_hle.sim(ACLK1, NFLOAD, NFSTEP, FreqTable[freq_reg_hle.get()], NSIN);
+	}
+
+	void NoiseChan::sim_RandomLFSRHLE()
+	{
+		TriState ACLK1 = apu->wire.ACLK1;
+		TriState W400E = apu->wire.W400E;
+		TriState NORND = apu->wire.NORND;
+		TriState LOCK = apu->wire.LOCK;
+
+		rmod_reg.sim(ACLK1, W400E, apu->GetDBBit(7));
+
+		uint32_t sout = rnd_sout_hle;
+		TriState sout0 = (sout & 0x01) != 0 ? TriState::One : TriState::Zero;
+
+		TriState RSOZ = sout == 0 ? TriState::One : TriState::Zero;
+		TriState mux_out = (sout & (rmod_reg.get() == TriState::One ? 0x40 : 0x02)) != 0 ? TriState::One : TriState::Zero;
+		TriState RIN = NOR3(LOCK, NOR3(RSOZ, sout0, mux_out), AND(sout0, mux_out));
+		RNDOUT = NOR(NOR(sout0, NORND), LOCK);
+
+		// in_reg takes the output of the next bit while ACLK1 = 0, out_latch takes in_reg during ACLK1.
+
+		if (ACLK1 == TriState::Zero && RSTEP == TriState::One)
+		{
+			rnd_in_hle = (sout >> 1) | (RIN == TriState::One ? 0x4000 : 0);
+		}
+
+		if (ACLK1 == TriState::One)
+		{
+			rnd_sout_hle = rnd_in_hle;
+		}
+	}
+
 	// Square Channels
 
 	SquareChan::SquareChan(APU* parent, SquareChanCarryIn carry_routing)
@@ -1407,23 +1963,45 @@ namespace APUSim
 
 	void SquareChan::sim(TriState WR0, TriState WR1, TriState WR2, TriState WR3, TriState NOSQ, TriState* SQ_Out)
 	{
-		dir_reg.sim(apu->wire.ACLK1, WR1, apu->GetDBBit(3));
-		DEC = dir_reg.get();
-		INC = NOT(DEC);
+		if (apu->HLE)
+		{
+			sim_HLE(WR0, WR1, WR2, WR3, NOSQ);
+		}
+		else
+		{
+			dir_reg.sim(apu->wire.ACLK1, WR1, apu->GetDBBit(3));
+			DEC = dir_reg.get();
+			INC = NOT(DEC);
 
-		sim_ShiftReg(WR1);
-		sim_Sweep(WR1, NOSQ);
+			sim_ShiftReg(WR1);
+			sim_Sweep(WR1, NOSQ);
 
-		sim_FreqReg(WR2, WR3);
-		sim_BarrelShifter();
-		sim_Adder();
-		sim_FreqCounter();
-		sim_Duty(WR0, WR3);
+			sim_FreqReg(WR2, WR3);
+			sim_BarrelShifter();
+			sim_Adder();
+			sim_FreqCounter();
+			sim_Duty(WR0, WR3);
+		}
 
 		env_unit->sim(Vol, WR0, WR3);
 		sim_Output(NOSQ, SQ_Out);
 	}
 
+	void SquareChan::sim_Idle()
+	{
+		// The frequency counter and the duty counter run while the channel is silenced. Without the frame counter events there is no sweep, so the frequency is constant.
+
+		if (apu->HLE)
+		{
+			sim_FreqCounterHLE(TriState::Zero, TriState::Zero);
+		}
+		else
+		{
+			sim_FreqCounter();
+			sim_Duty(TriState::Zero, TriState::Zero);
+		}
+	}
+
 	void SquareChan::sim_FreqReg(TriState WR2, TriState WR3)
 	{
 		TriState nACLK2 = apu->wire.nACLK2;
@@ -1639,6 +2217,127 @@ namespace APUSim
 		return env_unit->get_LC();
 	}
 
+	const uint8_t SquareChan::DutyTable[4] = { 0x80, 0xc0, 0xf0, 0x3f };
+
+	void SquareChan::sim_HLE(TriState WR0, TriState WR1, TriState WR2, TriState WR3, TriState NOSQ)
+	{
+		TriState ACLK1 = apu->wire.ACLK1;
+
+		sweep_reg_hle.sim(ACLK1, WR1, apu->DB, 0xff);
+		DEC = (sweep_reg_hle.get() & 0x08) != 0 ? TriState::One : TriState::Zero;
+		INC = NOT(DEC);
+
+		sim_SweepHLE(WR1, NOSQ);
+		sim_FreqRegHLE(WR2, WR3);
+		sim_AdderHLE();
+		sim_FreqCounterHLE(WR0, WR3);
+	}
+
+	void SquareChan::sim_FreqCounterHLE(TriState WR0, TriState WR3)
+	{
+		TriState nACLK2 = apu->wire.nACLK2;
+		TriState ACLK1 = apu->wire.ACLK1;
+		TriState RES = apu->wire.RES;
+
+		// Frequency counter
+
+		FLOAD = NOR(nACLK2, fco_latch.nget());
+		TriState FSTEP = NOR(nACLK2, NOT(fco_latch.nget()));
+		FCO = freq_cnt_hle.sim(TriState::One, TriState::One, RES, FLOAD, FSTEP, ACLK1, Fx_hle);
+		fco_latch.set(FCO, ACLK1);
+
+		// Duty
+
+		ctrl_reg_hle.sim(ACLK1, WR0, apu->DB >> 6, 3);
+		duty_cnt_hle.sim(FCO, TriState::One, RES, WR3, FLOAD, ACLK1, 0);
+		DUTY = ((DutyTable[ctrl_reg_hle.get()] >> duty_cnt_hle.get()) & 1) != 0 ? TriState::One : TriState::Zero;
+	}
+
+	void SquareChan::sim_SweepHLE(TriState WR1, TriState NOSQ)
+	{
+		TriState ACLK1 = apu->wire.ACLK1;
+		TriState RES = apu->wire.RES;
+		TriState n_LFO2 = apu->wire.n_LFO2;
+		uint32_t reg = sweep_reg_hle.get();
+
+		reload_latch.set(reload_ff.get(), ACLK1);
+		reload_ff.set(NOR(NOR3(reload_ff.get(), n_LFO2, reload_latch.get()), WR1));
+
+		TriState SWDIS = (reg & 0x80) != 0 ? TriState::Zero : TriState::One;
+
+		TriState temp_reload = NOR(reload_latch.nget(), sco_latch.get());
+		TriState SSTEP = NOR(n_LFO2, NOT(temp_reload));
+		TriState SLOAD = NOR(n_LFO2, temp_reload);
+
+		TriState SCO = sweep_cnt_hle.sim(TriState::One, TriState::One, RES, SLOAD, SSTEP, ACLK1, (reg >> 4) & 7);
+		sco_latch.set(SCO, ACLK1);
+
+		SW_OVF = NOR(DEC, n_COUT);
+		TriState SRZ = (reg & 7) == 0 ? TriState::One : TriState::Zero;
+		DO_SWEEP = NOR7(SRZ, SWDIS, NOSQ, SW_OVF, sco_latch.nget(), n_LFO2, SW_UVF);
+	}
+
+	void SquareChan::sim_FreqRegHLE(TriState WR2, TriState WR3)
+	{
+		TriState nACLK2 = apu->wire.nACLK2;
+		TriState ACLK1 = apu->wire.ACLK1;
+		TriState ACLK3 = NOT(nACLK2);
+
+		// Fx is the register, or the adder result latched on the previous ACLK1 during the sweep.
+
+		uint32_t Fx = DO_SWEEP == TriState::One ? sum_hle : freq_hle;
+		uint32_t wr_mask = (WR2 == TriState::One ? 0xff : 0) | (WR3 == TriState::One ? 0x700 : 0);
+		uint32_t d = ACLK3 == TriState::One ? Fx : freq_hle;
+		freq_hle = ((apu->DB | (apu->DB << 8)) & wr_mask) | (d & ~wr_mask & 0x7ff);
+
+		if (ACLK1 == TriState::One)
+		{
+			sum_hle = adder_sum;
+		}
+
+		Fx_hle = DO_SWEEP == TriState::One ? sum_hle : freq_hle;
+	}
+
+	void SquareChan::sim_AdderHLE()
+	{
+		// nFx is not always the inversion of Fx: during the sweep it is 0 for the bits where the register is 1 and the sum is 0.
+
+		uint32_t Fx = Fx_hle;
+		uint32_t nFx = (DO_SWEEP == TriState::One ? ~(sum_hle | freq_hle) : ~freq_hle) & 0x7ff;
+
+		// Barrel shifter. The bits shifted in from above are DEC.
+
+		uint32_t BS = DEC == TriState::One ? (nFx | ~0x7ffu) : Fx;
+		uint32_t S = (BS >> (sweep_reg_hle.get() & 7)) & 0x7ff;
+
+		uint32_t carry = (cin_type == SquareChanCarryIn::Vdd || DEC == TriState::Zero) ? 0 : 1;
+
+		if (nFx == (~Fx & 0x7ff))
+		{
+			uint32_t sum = Fx + S + carry;
+			adder_sum = sum & 0x7ff;
+			carry = sum >> 11;
+		}
+		else
+		{
+			adder_sum = 0;
+			for (size_t n = 0; n < 11; n++)
+			{
+				uint32_t F = (Fx >> n) & 1;
+				uint32_t nF = (nFx >> n) & 1;
+				uint32_t Sn = (S >> n) & 1;
+				// The same terms as in AdderBit (without the output NORs)
+				uint32_t cout = (F & Sn) | (F & (Sn ^ 1) & carry) | (nF & Sn & carry);
+				uint32_t sum = (F & (Sn ^ 1) & (carry ^ 1)) | (nF & Sn & (carry ^ 1)) | (nF & (Sn ^ 1) & carry) | (F & Sn & carry);
+				adder_sum |= sum << n;
+				carry = cout;
+			}
+		}
+
+		n_COUT = carry != 0 ? TriState::Zero : TriState::One;
+		SW_UVF = (Fx & 0x7fc) == 0 ? TriState::One : TriState::Zero;
+	}
+
 	// Triangle Channel
 
 	TriangleChan::TriangleChan(APU* parent)
@@ -1653,6 +2352,13 @@ namespace APUSim
 	void TriangleChan::sim()
 	{
 		sim_Control();
+
+		if (apu->HLE)
+		{
+			sim_HLE();
+			return;
+		}
+
 		sim_LinearReg();
 		sim_LinearCounter();
 		sim_FreqReg();
@@ -1660,6 +2366,22 @@ namespace APUSim
 		sim_Output();
 	}
 
+	void TriangleChan::sim_Idle()
+	{
+		// The frequency counter runs while the channel is silenced. The output counter does not step (TSTEP is 0 with NOTRI = 1), so the output keeps its value.
+
+		n_FOUT = fout_latch.nget();
+
+		if (apu->HLE)
+		{
+			sim_FreqCounterHLE();
+		}
+		else
+		{
+			sim_FreqCounter();
+		}
+	}
+
 	void TriangleChan::sim_Control()
 	{
 		TriState ACLK1 = apu->wire.ACLK1;
@@ -1772,6 +2494,45 @@ namespace APUSim
 		return lc_reg.nget();
 	}
 
+	void TriangleChan::sim_HLE()
+	{
+		TriState ACLK1 = apu->wire.ACLK1;
+		TriState PHI1 = apu->wire.PHI1;
+		TriState RES = apu->wire.RES;
+
+		// Linear counter
+
+		lin_reg_hle.sim(ACLK1, apu->wire.W4008, apu->DB, 0x7f);
+		TCO = lin_cnt_hle.sim(TriState::One, TriState::One, RES, LOAD, STEP, ACLK1, lin_reg_hle.get());
+
+		// Frequency counter (clocked by PHI1)
+
+		freq_reg_hle.sim(PHI1, apu->wire.W400A, apu->DB, 0xff);
+		freq_reg_hle.sim(PHI1, apu->wire.W400B, apu->DB << 8, 0x700);
+		sim_FreqCounterHLE();
+
+		// Output counter (clocked by PHI1)
+
+		out_cnt_hle.sim(TriState::One, TriState::Zero, RES, apu->wire.W401A, TSTEP, PHI1, apu->DB);
+
+		uint32_t T = out_cnt_hle.get();
+		uint32_t out = (T & 0x10) != 0 ? T : ~T;
+		for (size_t n = 0; n < 4; n++)
+		{
+			apu->TRI_Out[n] = ((out >> n) & 1) != 0 ? TriState::One : TriState::Zero;
+		}
+	}
+
+	void TriangleChan::sim_FreqCounterHLE()
+	{
+		TriState PHI1 = apu->wire.PHI1;
+		TriState RES = apu->wire.RES;
+
+		TriState FLOAD = NOR(PHI1, n_FOUT);
+		TriState FSTEP = NOR(PHI1, NOT(n_FOUT));
+		fout_latch.set(freq_cnt_hle.sim(TriState::One, TriState::One, RES, FLOAD, FSTEP, PHI1, freq_reg_hle.get()), PHI1);
+	}
+
 	// Register Decoder
 
 	RegsDecoder::RegsDecoder(APU* parent)
@@ -1793,115 +2554,115 @@ namespace APUSim
 
 	void RegsDecoder::sim_Predecode()
 	{
-		TriState CpuA[16]{};
+		// REGWR/REGRD are NOR12 of A5-A13, /A14, A15 and R/W. Outside of $4000-$401F they are both 0, inside only R/W is left.
 
-		for (size_t n = 0; n < 16; n++)
+		if ((apu->CPU_Addr & 0xffe0) == 0x4000)
 		{
-			CpuA[n] = ((apu->CPU_Addr >> n) & 1) != 0 ? TriState::One : TriState::Zero;
+			nREGWR = NOT(NOR(apu->wire.RnW, TriState::Zero));
+			nREGRD = NOT(NOR(NOT(apu->wire.RnW), TriState::Zero));
+		}
+		else
+		{
+			nREGWR = TriState::One;
+			nREGRD = TriState::One;
 		}
-
-		auto REGWR = NOR12(CpuA[5], CpuA[6], CpuA[7], CpuA[8], CpuA[9], CpuA[10], CpuA[11], CpuA[12], CpuA[13], NOT(CpuA[14]), CpuA[15], apu->wire.RnW);
-		nREGWR = NOT(REGWR);
-
-		auto REGRD = NOR12(CpuA[5], CpuA[6], CpuA[7], CpuA[8], CpuA[9], CpuA[10], CpuA[11], CpuA[12], CpuA[13], NOT(CpuA[14]), CpuA[15], NOT(apu->wire.RnW));
-		nREGRD = NOT(REGRD);
 
 		apu->wire.n_DBGRD = NAND(apu->wire.DBG, NOT(nREGRD));
 	}
 
+	const uint8_t RegsDecoder::Decoder[32] =
+	{
+		// $4000-$4008
+		DecoderWrite, DecoderWrite, DecoderWrite, DecoderWrite, DecoderWrite, DecoderWrite, DecoderWrite, DecoderWrite, DecoderWrite,
+		// $4009: none, $400A-$400C
+		0, DecoderWrite, DecoderWrite, DecoderWrite,
+		// $400D: none, $400E-$4014
+		0, DecoderWrite, DecoderWrite, DecoderWrite, DecoderWrite, DecoderWrite, DecoderWrite, DecoderWrite,
+		// $4015-$4017
+		DecoderWrite | DecoderRead, DecoderWrite | DecoderRead, DecoderWrite | DecoderRead,
+		// $4018-$401A: debug registers
+		DecoderRead | DecoderDebug, DecoderRead | DecoderDebug, DecoderWrite | DecoderRead | DecoderDebug,
+		// $401B-$401F: none
+		0, 0, 0, 0, 0,
+	};
+
 	void RegsDecoder::sim_Decoder()
 	{
-		TriState A[5]{};
-		TriState nA[5]{};
+		// Select a register index.
+		// Note that during PHI1 all write operations are disabled.
 
-		// Decoder
+		apu->wr_strobes = 0;
+		apu->rd_strobes = 0;
 
-		for (size_t n = 0; n < 5; n++)
+		if (nREGWR == TriState::One && nREGRD == TriState::One)
 		{
-			A[n] = ((apu->Ax >> n) & 1) != 0 ? TriState::One : TriState::Zero;
+			return;
 		}
 
-		for (size_t n = 0; n < 5; n++)
+		size_t reg = apu->Ax & 0x1f;
+		uint8_t dec = Decoder[reg];
+
+		if ((dec & DecoderDebug) != 0 && apu->wire.DBG != TriState::One)
 		{
-			nA[n] = NOT(A[n]);
+			return;
 		}
 
-		pla[0] = NOR6(nREGRD, A[0], A[1], A[2], nA[3], nA[4]);
-		pla[1] = NOR6(nREGRD, nA[0], A[1], A[2], nA[3], nA[4]);
-		pla[2] = NOR6(nREGRD, A[0], nA[1], A[2], nA[3], nA[4]);
-		pla[3] = NOR6(nREGWR, A[0], nA[1], A[2], nA[3], nA[4]);
-
-		pla[4] = NOR6(nREGRD, nA[0], A[1], nA[2], A[3], nA[4]);
-		pla[5] = NOR6(nREGWR, nA[0], nA[1], A[2], A[3], A[4]);
-		pla[6] = NOR6(nREGWR, A[0], nA[1], A[2], A[3], A[4]);
-		pla[7] = NOR6(nREGWR, nA[0], nA[1], nA[2], A[3], A[4]);
-		pla[8] = NOR6(nREGWR, nA[0], A[1], A[2], A[3], A[4]);
-
-		pla[9] = NOR6(nREGWR, A[0], A[1], nA[2], A[3], A[4]);
-		pla[10] = NOR6(nREGWR, nA[0], A[1], nA[2], A[3], A[4]);
-		pla[11] = NOR6(nREGWR, A[0], A[1], nA[2], nA[3], A[4]);
-		pla[12] = NOR6(nREGWR, A[0], nA[1], nA[2], A[3], A[4]);
-		pla[13] = NOR6(nREGWR, A[0], A[1], A[2], A[3], A[4]);
-
-		pla[14] = NOR6(nREGWR, A[0], A[1], A[2], nA[3], A[4]);
-		pla[15] = NOR6(nREGWR, nA[0], A[1], nA[2], A[3], nA[4]);
-		pla[16] = NOR6(nREGWR, A[0], nA[1], A[2], nA[3], A[4]);
-		pla[17] = NOR6(nREGWR, nA[0], A[1], A[2], A[3], nA[4]);
-		pla[18] = NOR6(nREGWR, nA[0], nA[1], A[2], nA[3], A[4]);
-
-		pla[19] = NOR6(nREGWR, nA[0], nA[1], nA[2], nA[3], A[4]);
-		pla[20] = NOR6(nREGWR, A[0], nA[1], nA[2], nA[3], A[4]);
-		pla[21] = NOR6(nREGRD, nA[0], nA[1], nA[2], A[3], nA[4]);
-		pla[22] = NOR6(nREGWR, nA[0], nA[1], A[2], A[3], nA[4]);
-		pla[23] = NOR6(nREGRD, A[0], nA[1], nA[2], A[3], nA[4]);
+		if ((dec & DecoderWrite) != 0 && nREGWR == TriState::Zero && apu->wire.PHI1 == TriState::Zero)
+		{
+			apu->wr_strobes = 1 << reg;
+		}
 
-		pla[24] = NOR6(nREGWR, A[0], nA[1], A[2], A[3], nA[4]);
-		pla[25] = NOR6(nREGWR, A[0], nA[1], nA[2], A[3], nA[4]);
-		pla[26] = NOR6(nREGWR, A[0], A[1], A[2], A[3], nA[4]);
-		pla[27] = NOR6(nREGWR, nA[0], nA[1], nA[2], A[3], nA[4]);
-		pla[28] = NOR6(nREGWR, A[0], A[1], nA[2], A[3], nA[4]);
+		if ((dec & DecoderRead) != 0 && nREGRD == TriState::Zero)
+		{
+			apu->rd_strobes = 1 << reg;
+		}
 	}
 
 	void RegsDecoder::sim_RegOps()
 	{
-		TriState PHI1 = apu->wire.PHI1;
-		TriState DBG = apu->wire.DBG;
+		// The wires only change with the strobe masks.
 
-		// Select a register index.
-		// Note that during PHI1 all write operations are disabled.
+		uint32_t wr = apu->wr_strobes;
+		uint32_t rd = apu->rd_strobes;
 
-		apu->wire.n_R4018 = NAND(DBG, pla[0]);
-		apu->wire.n_R401A = NAND(DBG, pla[2]);
-
-		apu->wire.n_R4015 = NOT(pla[4]);
-		apu->wire.W4002 = NOR(PHI1, NOT(pla[6]));
-		apu->wire.W4001 = NOR(PHI1, NOT(pla[8]));
-		apu->wire.W4005 = NOR(PHI1, NOT(pla[10]));
-		apu->wire.W4006 = NOR(PHI1, NOT(pla[12]));
-		apu->wire.W4008 = NOR(PHI1, NOT(pla[14]));
-		apu->wire.W400A = NOR(PHI1, NOT(pla[16]));
-		apu->wire.W400B = NOR(PHI1, NOT(pla[18]));
-		apu->wire.W400E = NOR(PHI1, NOT(pla[20]));
-		apu->wire.W4013 = NOR(PHI1, NOT(pla[22]));
-		apu->wire.W4012 = NOR(PHI1, NOT(pla[24]));
-		apu->wire.W4010 = NOR(PHI1, NOT(pla[26]));
-		apu->wire.W4014 = NOR(PHI1, NOT(pla[28]));
-
-		apu->wire.n_R4019 = NAND(DBG, pla[1]);
-		apu->wire.W401A = NOR(PHI1, NAND(DBG, pla[3]));
-
-		apu->wire.W4003 = NOR(PHI1, NOT(pla[5]));
-		apu->wire.W4007 = NOR(PHI1, NOT(pla[7]));
-		apu->wire.W4004 = NOR(PHI1, NOT(pla[9]));
-		apu->wire.W400C = NOR(PHI1, NOT(pla[11]));
-		apu->wire.W4000 = NOR(PHI1, NOT(pla[13]));
-		apu->wire.W4015 = NOR(PHI1, NOT(pla[15]));
-		apu->wire.W4011 = NOR(PHI1, NOT(pla[17]));
-		apu->wire.W400F = NOR(PHI1, NOT(pla[19]));
-		apu->wire.n_R4017 = NOT(pla[21]);
-		apu->wire.n_R4016 = NOT(pla[23]);
-		apu->wire.W4016 = NOR(PHI1, NOT(pla[25]));
-		apu->wire.W4017 = NOR(PHI1, NOT(pla[27]));
+		if (wr == wires_wr && rd == wires_rd)
+		{
+			return;
+		}
+
+		wires_wr = wr;
+		wires_rd = rd;
+
+		apu->wire.n_R4015 = (rd & (1 << 0x15)) != 0 ? TriState::Zero : TriState::One;
+		apu->wire.n_R4016 = (rd & (1 << 0x16)) != 0 ? TriState::Zero : TriState::One;
+		apu->wire.n_R4017 = (rd & (1 << 0x17)) != 0 ? TriState::Zero : TriState::One;
+		apu->wire.n_R4018 = (rd & (1 << 0x18)) != 0 ? TriState::Zero : TriState::One;
+		apu->wire.n_R4019 = (rd & (1 << 0x19)) != 0 ? TriState::Zero : TriState::One;
+		apu->wire.n_R401A = (rd & (1 << 0x1a)) != 0 ? TriState::Zero : TriState::One;
+
+		apu->wire.W4000 = (wr & (1 << 0x00)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4001 = (wr & (1 << 0x01)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4002 = (wr & (1 << 0x02)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4003 = (wr & (1 << 0x03)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4004 = (wr & (1 << 0x04)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4005 = (wr & (1 << 0x05)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4006 = (wr & (1 << 0x06)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4007 = (wr & (1 << 0x07)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4008 = (wr & (1 << 0x08)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W400A = (wr & (1 << 0x0a)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W400B = (wr & (1 << 0x0b)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W400C = (wr & (1 << 0x0c)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W400E = (wr & (1 << 0x0e)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W400F = (wr & (1 << 0x0f)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4010 = (wr & (1 << 0x10)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4011 = (wr & (1 << 0x11)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4012 = (wr & (1 << 0x12)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4013 = (wr & (1 << 0x13)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4014 = (wr & (1 << 0x14)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4015 = (wr & (1 << 0x15)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4016 = (wr & (1 << 0x16)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W4017 = (wr & (1 << 0x17)) != 0 ? TriState::One : TriState::Zero;
+		apu->wire.W401A = (wr & (1 << 0x1a)) != 0 ? TriState::One : TriState::Zero;
 	}
 
 	void RegsDecoder::sim_DebugLock()
@@ -2118,10 +2879,19 @@ namespace APUSim
 
 	// Obtaining the analog value of the AUX A/B signals from the digital outputs of the generators.
 
+	float DAC::auxa_mv[0x100];
+	float DAC::auxa_norm[0x100];
+	float DAC::auxb_mv[32768];
+	float DAC::auxb_norm[32768];
+
 	DAC::DAC(APU* parent)
 	{
 		apu = parent;
-		gen_DACTabs();
+
+		// The tables are filled by the first instance; the initialization of a local static is thread-safe.
+
+		static const bool tabs_done = gen_DACTabs();
+		(void)tabs_done;
 	}
 
 	DAC::~DAC()
@@ -2187,7 +2957,7 @@ namespace APUSim
 		norm_mode = enable;
 	}
 
-	void DAC::gen_DACTabs()
+	bool DAC::gen_DACTabs()
 	{
 		// AUX A
 
@@ -2254,6 +3024,8 @@ namespace APUSim
 				}
 			}
 		}
+
+		return true;
 	}
 
 	/// <summary>
@@ -2363,12 +3135,21 @@ namespace APUSim
 
 	// APU Main
 
-	APU::APU(M6502Core::M6502* _core, Revision _rev, ChipFeature features)
+	APU::APU(M6502Core::M6502* _core, Revision _rev, ChipFeature features, bool hle)
 	{
 		// For ease of integration, the core instance is created by the consumer
 		core = _core;
 		rev = _rev;
-		fx = features;
+		fx = features == ChipFeature::ByRevision ? GetRevisionFeatures(rev) : features;
+		HLE = hle;
+
+#if _DEBUG
+		if (HLE)
+		{
+			lockstep = new APU(core, rev, fx, false);
+			lockstep->leader = this;
+		}
+#endif
 
 		core_int = new CoreBinding(this);
 		clkgen = new CLKGen(this);
@@ -2406,10 +3187,17 @@ namespace APUSim
 		delete dma;
 		delete pads;
 		delete dac;
+		delete lockstep;
+
+		SetWriteLog(nullptr);
 	}
 
 	void APU::sim(TriState inputs[], TriState outputs[], uint8_t* data, uint16_t* addr, AudioOutSignal& AUX)
 	{
+#if _DEBUG
+		uint8_t data_in = *data;
+#endif
+
 		pads->sim_InputPads(inputs);
 		pads->sim_DataBusInput(data);
 
@@ -2426,6 +3214,80 @@ namespace APUSim
 		pads->sim_OutputPads(outputs, addr);
 		pads->sim_DataBusOutput(data);
 		dac->sim(AUX);
+
+		if (audio_blocks != nullptr)
+		{
+			sim_AudioBlocks(AUX);
+		}
+
+#if _DEBUG
+		if (lockstep != nullptr)
+		{
+			sim_Lockstep(inputs, outputs, data_in);
+		}
+#endif
+	}
+
+	void APU::sim_Lockstep(TriState inputs[], TriState outputs[], uint8_t data_in)
+	{
+		TriState gate_outputs[(size_t)APU_Output::Max]{};
+		uint16_t gate_addr = 0;
+		AudioOutSignal gate_aux{};
+
+		lockstep->sim(inputs, gate_outputs, &data_in, &gate_addr, gate_aux);
+
+		// The gate-level APU never skips the idle channels, so with SetIdleChannelSkip this also checks that the skip does not change the DAC inputs.
+
+		bool match = DB == lockstep->DB && Ax == lockstep->Ax && DMC_Addr == lockstep->DMC_Addr;
+
+		for (size_t n = 0; n < (size_t)APU_Output::Max; n++)
+		{
+			match = match && outputs[n] == gate_outputs[n];
+		}
+
+		for (size_t n = 0; n < 4; n++)
+		{
+			match = match && SQA_Out[n] == lockstep->SQA_Out[n] && SQB_Out[n] == lockstep->SQB_Out[n] &&
+				TRI_Out[n] == lockstep->TRI_Out[n] && RND_Out[n] == lockstep->RND_Out[n];
+		}
+
+		for (size_t n = 0; n < 7; n++)
+		{
+			match = match && DMC_Out[n] == lockstep->DMC_Out[n];
+		}
+
+		match = match && wire.NOSQA == lockstep->wire.NOSQA && wire.NOSQB == lockstep->wire.NOSQB &&
+			wire.NOTRI == lockstep->wire.NOTRI && wire.NORND == lockstep->wire.NORND &&
+			wire.INT == lockstep->wire.INT && wire.n_LFO1 == lockstep->wire.n_LFO1 && wire.n_LFO2 == lockstep->wire.n_LFO2 &&
+			wire.DMCINT == lockstep->wire.DMCINT && wire.RUNDMC == lockstep->wire.RUNDMC &&
+			wire.n_DMC_AB == lockstep->wire.n_DMC_AB && wire.DMCRDY == lockstep->wire.DMCRDY;
+
+		if (!match)
+		{
+			throw "APU HLE does not match the gate-level model.";
+		}
+	}
+
+	void APU::sim_AudioBlocks(AudioOutSignal& AUX)
+	{
+		if (audio_blocks->fill >= audio_blocks->size)
+		{
+			if (audio_blocks->ready)
+			{
+				audio_blocks->overflow = true;
+			}
+
+			audio_blocks->ready = true;
+			audio_blocks->current ^= 1;
+			audio_blocks->fill = 0;
+
+			if (audio_blocks->callback != nullptr)
+			{
+				audio_blocks->callback(audio_blocks, audio_blocks->opaque);
+			}
+		}
+
+		audio_blocks->blocks[audio_blocks->current][audio_blocks->fill++] = AUX;
 	}
 
 	void APU::sim_CoreIntegration()
@@ -2447,6 +3309,13 @@ namespace APUSim
 		}
 		PrevPHI_SoundGen = wire.PHI0;
 
+		if (idle_skip)
+		{
+			sim_IdleChannels();
+			sim_Stems();
+			return;
+		}
+
 		// Sound channels
 
 		wire.SQA_LC = square[0]->get_LC();
@@ -2463,6 +3332,152 @@ namespace APUSim
 		square[1]->sim(wire.W4004, wire.W4005, wire.W4006, wire.W4007, wire.NOSQB, SQB_Out);
 		tri->sim();
 		noise->sim();
+
+		sim_Stems();
+	}
+
+	void APU::sim_Stems()
+	{
+		// Once per PHI cycle, after the PHI2 half
+
+		if (stems == nullptr || wire.PHI0 != TriState::One)
+		{
+			return;
+		}
+
+		uint8_t value[(size_t)AudioStem::Max]{};
+		value[(size_t)AudioStem::SQA] = PackNibble(SQA_Out);
+		value[(size_t)AudioStem::SQB] = PackNibble(SQB_Out);
+		value[(size_t)AudioStem::TRI] = PackNibble(TRI_Out);
+		value[(size_t)AudioStem::RND] = PackNibble(RND_Out);
+		value[(size_t)AudioStem::DMC] = Pack(DMC_Out);
+
+		for (size_t n = 0; n < (size_t)AudioStem::Max; n++)
+		{
+			size_t count = stems->count[n];
+
+			if (stems->rle)
+			{
+				if (count != 0 && stems->runs[n][count - 1].value == value[n] && stems->runs[n][count - 1].length != UINT32_MAX)
+				{
+					stems->runs[n][count - 1].length++;
+				}
+				else if (count < stems->capacity)
+				{
+					stems->runs[n][count].value = value[n];
+					stems->runs[n][count].length = 1;
+					stems->count[n]++;
+				}
+				else
+				{
+					stems->overflow = true;
+				}
+			}
+			else
+			{
+				if (count < stems->capacity)
+				{
+					stems->samples[n][count] = value[n];
+					stems->count[n]++;
+				}
+				else
+				{
+					stems->overflow = true;
+				}
+			}
+		}
+	}
+
+	void APU::sim_WriteLog()
+	{
+		// PHI2 of a write cycle to $4000-$4017
+
+		if (wire.RnW != TriState::Zero || CPU_Addr < 0x4000 || CPU_Addr > 0x4017)
+		{
+			return;
+		}
+
+		RegWrite entry{};
+		entry.delta = (uint32_t)(phi_counter - write_log_phi);
+		entry.reg = (uint8_t)(CPU_Addr & 0x1f);
+		entry.value = DB;
+		fwrite(&entry, sizeof(RegWrite), 1, write_log);
+
+		write_log_phi = phi_counter;
+	}
+
+	void APU::sim_IdleChannels()
+	{
+		// Events that concern all channels: reset, frame counter (envelope, linear counter, length counter and sweep), $4015 and the test mode.
+
+		bool common = wire.RES == TriState::One || wire.n_LFO1 == TriState::Zero || wire.n_LFO2 == TriState::Zero ||
+			(wr_strobes & (1 << 0x15)) != 0 || (rd_strobes & (1 << 0x15)) != 0 || wire.LOCK == TriState::One;
+
+		// A channel is awake while it is audible or its registers are written.
+
+		bool event[4]{};
+		event[0] = common || wire.NOSQA == TriState::Zero || (wr_strobes & 0x0000000f) != 0;		// $4000-$4003
+		event[1] = common || wire.NOSQB == TriState::Zero || (wr_strobes & 0x000000f0) != 0;		// $4004-$4007
+		event[2] = common || wire.NOTRI == TriState::Zero || (wr_strobes & 0x04000d00) != 0;		// $4008, $400A, $400B, $401A
+		event[3] = common || wire.NORND == TriState::Zero || (wr_strobes & 0x0000d000) != 0;		// $400C, $400E, $400F
+
+		for (size_t n = 0; n < 4; n++)
+		{
+			if (event[n])
+			{
+				awake[n] = IdleSettleEdges;
+			}
+			else if (awake[n] != 0)
+			{
+				awake[n]--;
+			}
+		}
+
+		// The same as sim_SoundGenerators for the channels that are awake. A sleeping channel keeps its outputs (the DAC inputs and NOxx) and only its free-running counters are simulated.
+
+		if (awake[0] != 0)
+		{
+			wire.SQA_LC = square[0]->get_LC();
+			lc[0]->sim(0, wire.W4003, wire.SQA_LC, wire.NOSQA);
+			square[0]->sim(wire.W4000, wire.W4001, wire.W4002, wire.W4003, wire.NOSQA, SQA_Out);
+		}
+		else
+		{
+			square[0]->sim_Idle();
+		}
+
+		if (awake[1] != 0)
+		{
+			wire.SQB_LC = square[1]->get_LC();
+			lc[1]->sim(1, wire.W4007, wire.SQB_LC, wire.NOSQB);
+			square[1]->sim(wire.W4004, wire.W4005, wire.W4006, wire.W4007, wire.NOSQB, SQB_Out);
+		}
+		else
+		{
+			square[1]->sim_Idle();
+		}
+
+		if (awake[2] != 0)
+		{
+			wire.TRI_LC = tri->get_LC();
+			lc[2]->sim(2, wire.W400B, wire.TRI_LC, wire.NOTRI);
+			tri->sim();
+		}
+		else
+		{
+			tri->sim_Idle();
+		}
+
+		if (awake[3] != 0)
+		{
+			wire.RND_LC = noise->get_LC();
+			lc[3]->sim(3, wire.W400F, wire.RND_LC, wire.NORND);
+			noise->sim();
+		}
+		else
+		{
+			noise->sim_Idle();
+		}
 	}
 
 	TriState APU::GetDBBit(size_t n)
@@ -2491,6 +3506,69 @@ namespace APUSim
 		dac->SetNormalizedOutput(enable);
 	}
 
+	void APU::SetAudioStems(AudioStems* buffers)
+	{
+		stems = buffers;
+	}
+
+	void APU::SetAudioBlocks(AudioBlocks* blocks)
+	{
+		audio_blocks = blocks;
+	}
+
+	bool APU::GetDMAStats(DMAStats& stats)
+	{
+		stats = dma_stats;
+		return APU_DMA_STATS != 0;
+	}
+
+	void APU::ResetDMAStats()
+	{
+		dma_stats = {};
+	}
+
+	bool APU::SetWriteLog(const char* filename)
+	{
+		if (write_log != nullptr)
+		{
+			fclose(write_log);
+			write_log = nullptr;
+		}
+
+		if (filename == nullptr)
+		{
+			return true;
+		}
+
+		write_log = fopen(filename, "wb");
+		write_log_phi = phi_counter;
+		return write_log != nullptr;
+	}
+
+	void APU::HoldCore(bool idle)
+	{
+		core_idle = idle;
+	}
+
+	void APU::SetWriteReplay(const RegWrite* entries, size_t count)
+	{
+		replay = entries;
+		replay_count = entries != nullptr ? count : 0;
+		replay_pos = 0;
+		replay_phi = phi_counter + (replay_count != 0 ? entries[0].delta : 0);
+		replay_active = false;
+	}
+
+	void APU::SetIdleChannelSkip(bool enable)
+	{
+		idle_skip = enable;
+
+		for (size_t n = 0; n < 4; n++)
+		{
+			awake[n] = IdleSettleEdges;
+		}
+	}
+
 	size_t APU::GetACLKCounter()
 	{
 		return aclk_counter;
@@ -2511,14 +3589,31 @@ namespace APUSim
 		phi_counter = 0;
 	}
 
+	ChipFeature APU::GetRevisionFeatures(Revision rev)
+	{
+		// Only the clock is known for the presets so far; the rest of the features are left to the custom chips.
+
+		switch (rev)
+		{
+			case Revision::RP2A07:
+				return (ChipFeature)(ChipFeature::QuartzPal | ChipFeature::DividerPal);
+
+			case Revision::UA6527P:
+				return (ChipFeature)(ChipFeature::QuartzPal | ChipFeature::DividerCustom);		// Dendy: PAL quartz, divided by 15
+
+			default:
+				return (ChipFeature)(ChipFeature::QuartzNtsc | ChipFeature::DividerNtsc);
+		}
+	}
+
 	void APU::GetSignalFeatures(AudioSignalFeatures& features)
 	{
-		size_t clk = 21477272;	// Hz
-		size_t div = 12;
+		size_t clk = (fx & ChipFeature::QuartzPal) != 0 ? 26601712 : 21477272;	// Hz
+		size_t div = (fx & ChipFeature::DividerPal) != 0 ? 16 : ((fx & ChipFeature::DividerCustom) != 0 ? 15 : 12);
 
 		features.SampleRate = (int32_t)(clk * 2);
 
-		// TBD: Add other APU
+		// TBD: The divider itself (CoreBinding) is NTSC only for now
 	}
 
 	TriState APU::GetPHI2()
@@ -19,6 +19,12 @@
 
 #pragma once
 
+// Collect the DMA statistics (see APU::GetDMAStats). Build with APU_DMA_STATS=1 to turn it on, otherwise the counting code is not compiled at all.
+
+#ifndef APU_DMA_STATS
+#define APU_DMA_STATS 0
+#endif
+
 namespace APUSim
 {
 	class APU;
@@ -67,8 +73,84 @@ namespace APUSim
 		float AUXB_HighLevel;		// Upper signal level for AUX_B (mV)
 	};
 
+	/// <summary>
+	/// An entry of the register write log ($4000-$4017). The log file is just a sequence of such entries.
+	/// </summary>
+	struct RegWrite
+	{
+		uint32_t delta;		// Number of PHI cycles since the previous write (since the start of the log for the first entry)
+		uint8_t reg;		// Register index (0x00-0x17)
+		uint8_t value;
+	};
+
 #pragma pack(pop)
 
+	/// <summary>
+	/// Sound channels, in the order of the stem buffers.
+	/// </summary>
+	enum class AudioStem
+	{
+		SQA = 0,		// 4 bit
+		SQB,			// 4 bit
+		TRI,			// 4 bit
+		RND,			// 4 bit
+		DMC,			// 7 bit
+		Max,
+	};
+
+	/// <summary>
+	/// A run of the same DAC input value (run-length encoded stem).
+	/// </summary>
+	struct AudioStemRun
+	{
+		uint8_t value;
+		uint32_t length;		// Number of PHI cycles
+	};
+
+	/// <summary>
+	/// Caller buffers for the DAC inputs of each sound channel (one value per PHI cycle, before the DAC).
+	/// The APU appends to the buffers; the caller drains them and sets `count` back to 0. When a buffer is full, the values are dropped and `overflow` is set.
+	/// </summary>
+	struct AudioStems
+	{
+		bool rle;										// false: `samples` are used, true: `runs` are used
+		size_t capacity;								// Size of each buffer (in samples or runs)
+		uint8_t* samples[(size_t)AudioStem::Max];
+		AudioStemRun* runs[(size_t)AudioStem::Max];
+		size_t count[(size_t)AudioStem::Max];			// Number of filled samples or runs
+		bool overflow;
+	};
+
+	/// <summary>
+	/// Caller buffers for the DAC output, collected in blocks at the native sample rate (one sample per APU::sim, see AudioSignalFeatures::SampleRate).
+	/// The APU fills the two blocks in turn. When a block is full, `ready` is set and `callback` is called (if any); the completed block is blocks[current ^ 1]. The caller clears `ready` when it has taken the block.
+	/// A block is completed on the APU::sim call after its last sample, so that the board can add its part of the last sample (the cartridge sound) after APU::sim.
+	/// </summary>
+	struct AudioBlocks
+	{
+		AudioOutSignal* blocks[2];
+		float* cart[2];									// Optional (nullptr: not collected): the cartridge sound of each sample, written by the board
+		size_t size;									// Size of each block in samples
+		size_t fill;									// Number of filled samples of the current block
+		size_t current;									// The block being filled
+		bool ready;
+		bool overflow;									// A block was completed while the previous one was still not taken
+		void (*callback)(AudioBlocks* blocks, void* opaque);
+		void* opaque;
+	};
+
+	/// <summary>
+	/// DMA counters (see APU::GetDMAStats). The CPU is halted while RDY = 0 and the core is on a read cycle; if both DMAs hold RDY, the cycle is counted for the OAM DMA.
+	/// </summary>
+	struct DMAStats
+	{
+		size_t spr_halt_cycles;		// PHI cycles the CPU was halted by the OAM DMA ($4014)
+		size_t dmc_halt_cycles;		// PHI cycles the CPU was halted by the DMC sample fetch
+		size_t spr_dma_starts;		// Number of OAM DMAs
+		size_t dmc_dma_starts;		// Number of DMC sample fetches
+		size_t dmc_irqs;			// Number of DMC interrupts (DMCINT 0->1)
+	};
+
 	/// <summary>
 	/// All known revisions of official APUs and compatible clones.
 	/// </summary>
@@ -219,6 +301,62 @@ namespace APUSim
 		void set(BaseLogic::TriState val);
 	};
 
+	// The same elements packed into integers (APU HLE mode).
+	// All bits of a register or a counter share the control signals, so a whole chain is simulated with a few integer operations. The result is the same as the bit-by-bit simulation, including the power-up state of the latches.
+
+	class PackedRegister
+	{
+		uint32_t value = 0;
+
+	public:
+		/// <summary>
+		/// The same as RegisterBit/RegisterBitRes for the bits selected by `mask`.
+		/// </summary>
+		void sim(BaseLogic::TriState ACLK1, BaseLogic::TriState Enable, uint32_t val, uint32_t mask, BaseLogic::TriState Res = BaseLogic::TriState::Zero);
+		uint32_t get();
+	};
+
+	class PackedCounter
+	{
+		uint32_t mask = 0;
+		uint32_t value = 0;		// transp_latch of each bit
+		uint32_t next = 0;		// cg_latch of each bit: the value after Step
+
+	public:
+		PackedCounter(size_t bits);
+
+		/// <summary>
+		/// The same as a chain of CounterBit (Dec = 0), DownCounterBit (Dec = 1) or RevCounterBit.
+		/// </summary>
+		/// <returns>Carry out of the last bit</returns>
+		BaseLogic::TriState sim(
+			BaseLogic::TriState Carry,
+			BaseLogic::TriState Dec,
+			BaseLogic::TriState Clear,
+			BaseLogic::TriState Load,
+			BaseLogic::TriState Step,
+			BaseLogic::TriState ACLK1,
+			uint32_t val);
+		uint32_t get();
+	};
+
+	/// <summary>
+	/// A chain of FreqLFSRBit/DPCM_LFSRBit. The value is shifted towards bit 0, `shift_in` goes to the msb.
+	/// </summary>
+	class PackedLFSR
+	{
+		uint32_t mask = 0;
+		size_t msb = 0;
+		uint32_t in = 0;		// in_latch of each bit
+		uint32_t sout = 0;		// out_latch of each bit (not inverted)
+
+	public:
+		PackedLFSR(size_t bits);
+
+		void sim(BaseLogic::TriState ACLK1, BaseLogic::TriState load, BaseLogic::TriState step, uint32_t val, BaseLogic::TriState shift_in);
+		uint32_t get_sout();
+	};
+
 	// Timing Generator
 
 	class SoftCLK_SRBit
@@ -261,6 +399,16 @@ namespace APUSim
 		RegisterBit reg_mode{};
 		RegisterBit reg_mask{};
 
+		// HLE: the LFSR packed into integers (bit n is lfsr[n])
+
+		uint32_t lfsr_in = 0;				// in_latch of the bits
+		uint32_t lfsr_sout = 0x7fff;		// out_latch of the bits (not inverted)
+
+		static const uint32_t PLA_Match[5];		// The LFSR values decoded by pla[0-4] (pla[5] is LFSR = 0)
+
+		void sim_SoftCLK_PLAHLE();
+		void sim_SoftCLK_LFSRHLE();
+
 		void sim_ACLK();
 		void sim_SoftCLK_Mode();
 		void sim_SoftCLK_Control();
@@ -299,6 +447,8 @@ namespace APUSim
 
 		void sim_DividerBeforeCore();
 		void sim_DividerAfterCore();
+		void sim_IdleCore();
+		void sim_FollowCore();
 
 	public:
 		CoreBinding(APU* parent);
@@ -334,6 +484,11 @@ namespace APUSim
 		BaseLogic::TriState DOSPR = BaseLogic::TriState::X;		// Latches the OAM DMA start event
 		BaseLogic::TriState sprdma_rdy = BaseLogic::TriState::X;	// aka oamdma_rdy
 
+#if APU_DMA_STATS
+		size_t stats_phi = 0;			// PHI counter of the last counted cycle
+		BaseLogic::TriState stats_nospr = BaseLogic::TriState::X;
+#endif
+
 		void sim_DMA_Address();
 		void sim_DMA_Control();
 
@@ -433,6 +588,32 @@ namespace APUSim
 		RevCounterBit out_cnt[6]{};
 		RegisterBit out_reg{};
 
+		// HLE
+
+		PackedRegister ctrl_reg_hle{};		// $4010
+		PackedLFSR lfsr_hle{ 9 };
+		PackedRegister scnt_reg_hle{};
+		PackedCounter scnt_hle{ 12 };
+		PackedCounter sbcnt_hle{ 3 };
+		PackedRegister buf_reg_hle{};
+		uint32_t shift_in_hle = 0;			// in_latch of the shift register bits
+		uint32_t shift_out_hle = 0;			// out_latch of the shift register bits
+		PackedRegister addr_reg_hle{};
+		PackedCounter addr_cnt_hle{ 15 };
+		PackedCounter out_cnt_hle{ 6 };
+
+		static const uint16_t FreqTable[16];		// FR outputs of the decoder
+
+#if APU_DMA_STATS
+		BaseLogic::TriState stats_dmc_ab = BaseLogic::TriState::X;
+		BaseLogic::TriState stats_int = BaseLogic::TriState::X;
+#endif
+
+		void sim_HLE();
+		void sim_FreqLFSRHLE();
+		void sim_SampleBufferHLE();
+		void sim_OutputHLE();
+
 		void sim_ControlReg();
 		void sim_IntControl();
 		void sim_EnableControl();
@@ -483,6 +664,12 @@ namespace APUSim
 		DownCounterBit cnt[8]{};
 		BaseLogic::TriState carry_out{};
 
+		// HLE
+
+		PackedCounter cnt_hle{ 8 };
+
+		static const uint8_t LengthTable[32];		// LC outputs of the decoder
+
 		void sim_Control(size_t bit_ena, BaseLogic::TriState WriteEn, BaseLogic::TriState& LC_NoCount);
 		void sim_Decoder1();
 		void sim_Decoder2();
@@ -513,6 +700,14 @@ namespace APUSim
 		BaseLogic::DLatch rco_latch{};
 		BaseLogic::DLatch eco_latch{};
 
+		// HLE
+
+		PackedRegister reg_hle{};			// Volume, envdis and lc bits of the register
+		PackedCounter decay_cnt_hle{ 4 };
+		PackedCounter env_cnt_hle{ 4 };
+
+		void sim_HLE(BaseLogic::TriState V[4], BaseLogic::TriState WR_Reg, BaseLogic::TriState WR_LC);
+
 	public:
 		EnvelopeUnit(APU* parent);
 		~EnvelopeUnit();
@@ -561,6 +756,18 @@ namespace APUSim
 		RandomLFSRBit rnd_lfsr[15]{};
 		EnvelopeUnit* env_unit = nullptr;
 
+		// HLE
+
+		PackedRegister freq_reg_hle{};
+		PackedLFSR freq_lfsr_hle{ 11 };
+		uint32_t rnd_in_hle = 0;			// in_reg of the random LFSR bits
+		uint32_t rnd_sout_hle = 0x7fff;		// out_latch of the random LFSR bits (not inverted)
+
+		static const uint16_t FreqTable[16];		// NNF outputs of the decoder
+
+		void sim_FreqLFSRHLE();
+		void sim_RandomLFSRHLE();
+
 		void sim_FreqReg();
 		void sim_Decoder1();
 		void sim_Decoder1_Calc(BaseLogic::TriState* F, BaseLogic::TriState* nF);
@@ -573,6 +780,7 @@ namespace APUSim
 		~NoiseChan();
 
 		void sim();
+		void sim_Idle();
 		BaseLogic::TriState get_LC();
 	};
 
@@ -650,6 +858,26 @@ namespace APUSim
 
 		EnvelopeUnit* env_unit = nullptr;
 
+		// HLE
+
+		PackedRegister ctrl_reg_hle{};		// Duty bits of $4000/$4004
+		PackedRegister sweep_reg_hle{};		// $4001/$4005
+		uint32_t freq_hle = 0;				// transp_latch of the frequency register bits
+		uint32_t sum_hle = 0x7ff;			// sum_latch of the frequency register bits (not inverted)
+		uint32_t adder_sum = 0x7ff;			// The adder output (not inverted)
+		uint32_t Fx_hle = 0;
+		PackedCounter freq_cnt_hle{ 11 };
+		PackedCounter sweep_cnt_hle{ 3 };
+		PackedCounter duty_cnt_hle{ 3 };
+
+		static const uint8_t DutyTable[4];		// DUTY output for each value of the duty counter, by the duty register
+
+		void sim_HLE(BaseLogic::TriState WR0, BaseLogic::TriState WR1, BaseLogic::TriState WR2, BaseLogic::TriState WR3, BaseLogic::TriState NOSQ);
+		void sim_SweepHLE(BaseLogic::TriState WR1, BaseLogic::TriState NOSQ);
+		void sim_FreqRegHLE(BaseLogic::TriState WR2, BaseLogic::TriState WR3);
+		void sim_AdderHLE();
+		void sim_FreqCounterHLE(BaseLogic::TriState WR0, BaseLogic::TriState WR3);
+
 		void sim_FreqReg(BaseLogic::TriState WR2, BaseLogic::TriState WR3);
 		void sim_ShiftReg(BaseLogic::TriState WR1);
 		void sim_BarrelShifter();
@@ -664,6 +892,7 @@ namespace APUSim
 		~SquareChan();
 
 		void sim(BaseLogic::TriState WR0, BaseLogic::TriState WR1, BaseLogic::TriState WR2, BaseLogic::TriState WR3, BaseLogic::TriState NOSQ, BaseLogic::TriState* SQ_Out);
+		void sim_Idle();
 		BaseLogic::TriState get_LC();
 	};
 
@@ -693,6 +922,17 @@ namespace APUSim
 		BaseLogic::DLatch fout_latch{};
 		CounterBit out_cnt[5]{};
 
+		// HLE
+
+		PackedRegister lin_reg_hle{};
+		PackedCounter lin_cnt_hle{ 7 };
+		PackedRegister freq_reg_hle{};
+		PackedCounter freq_cnt_hle{ 11 };
+		PackedCounter out_cnt_hle{ 5 };
+
+		void sim_HLE();
+		void sim_FreqCounterHLE();
+
 		void sim_Control();
 		void sim_LinearReg();
 		void sim_LinearCounter();
@@ -705,6 +945,7 @@ namespace APUSim
 		~TriangleChan();
 
 		void sim();
+		void sim_Idle();
 		BaseLogic::TriState get_LC();
 	};
 
@@ -714,11 +955,20 @@ namespace APUSim
 	{
 		APU* apu = nullptr;
 
-		BaseLogic::TriState pla[29]{};		// Decoder
+		// Decoder. Instead of the PLA, the low 5 bits of the address are looked up in the table, which gives the strobes of the register.
+
+		static const uint8_t DecoderWrite = 1;		// The register has a write strobe
+		static const uint8_t DecoderRead = 2;		// The register has a read strobe
+		static const uint8_t DecoderDebug = 4;		// The strobes only work in the debug mode (DBG = 1)
+		static const uint8_t Decoder[32];
 
 		BaseLogic::TriState nREGWR = BaseLogic::TriState::X;
 		BaseLogic::TriState nREGRD = BaseLogic::TriState::X;
 
+		// The strobe masks for which the wires were last set
+		uint32_t wires_wr = ~0;
+		uint32_t wires_rd = ~0;
+
 		BaseLogic::DLatch lock_latch{};
 
 		void sim_DebugLock();
@@ -793,21 +1043,23 @@ namespace APUSim
 		bool raw_mode = false;
 		bool norm_mode = false;
 
-		float auxa_mv[0x100]{};
-		float auxa_norm[0x100]{};
+		// The tables depend only on the resistances, so they are shared by all instances (read-only after the first DAC is created).
 
-		float auxb_mv[32768]{};
-		float auxb_norm[32768]{};
+		static float auxa_mv[0x100];
+		static float auxa_norm[0x100];
 
-		const float IntRes = 39000.f;		// Internal single MOSFET resistance
-		const float IntUnloaded = 999999.f;	// Non-loaded DAC internal resistance
-		const float ExtRes = 100.f;		// On-board pull-down resistor to GND
-		const float Vdd = 5.0f;
+		static float auxb_mv[32768];
+		static float auxb_norm[32768];
 
-		float AUX_A_Resistance(size_t sqa, size_t sqb);
-		float AUX_B_Resistance(size_t tri, size_t rnd, size_t dmc);
+		static constexpr float IntRes = 39000.f;		// Internal single MOSFET resistance
+		static constexpr float IntUnloaded = 999999.f;	// Non-loaded DAC internal resistance
+		static constexpr float ExtRes = 100.f;		// On-board pull-down resistor to GND
+		static constexpr float Vdd = 5.0f;
 
-		void gen_DACTabs();
+		static float AUX_A_Resistance(size_t sqa, size_t sqb);
+		static float AUX_B_Resistance(size_t tri, size_t rnd, size_t dmc);
+
+		static bool gen_DACTabs();
 
 		void sim_DACA(AudioOutSignal& aout);
 		void sim_DACB(AudioOutSignal& aout);
@@ -918,7 +1170,8 @@ namespace APUSim
 		} wire{};
 
 		Revision rev = Revision::Unknown;
-		ChipFeature fx = ChipFeature::ByRevision;
+		ChipFeature fx = ChipFeature::ByRevision;		// Resolved once in the constructor (ByRevision is replaced by the features of the revision)
+		bool HLE = false;			// The registers, counters and LFSRs of the sound channels and the frame counter are packed into integers
 
 		// Instances of internal APU modules, including the core
 
@@ -945,6 +1198,11 @@ namespace APUSim
 		uint16_t CPU_Addr{};		// Core to mux & regs predecoder
 		uint16_t Ax{};				// Mux to pads & regs decoder
 
+		// Register strobes packed by address: bit n is the access to $4000+n. The same as the W40xx / n_R40xx wires (see RegsDecoder).
+
+		uint32_t wr_strobes = 0;
+		uint32_t rd_strobes = 0;
+
 		// DAC Inputs
 
 		BaseLogic::TriState SQA_Out[4]{};
@@ -962,11 +1220,57 @@ namespace APUSim
 		BaseLogic::TriState PrevPHI_Core = BaseLogic::TriState::X;	// to optimize
 		BaseLogic::TriState PrevPHI_SoundGen = BaseLogic::TriState::X;	// to optimize
 
+		// Idle sound channels (see SetIdleChannelSkip). Order: SQA, SQB, TRI, RND.
+
+		static const size_t IdleSettleEdges = 16;		// How many PHI edges the channel is fully simulated after the last event, so that its latches settle
+		bool idle_skip = false;
+		size_t awake[4]{};
+
+		AudioStems* stems = nullptr;
+		AudioBlocks* audio_blocks = nullptr;
+
+		DMAStats dma_stats{};
+
+		// Register write log (see SetWriteLog) and its replay (see HoldCore, SetWriteReplay)
+
+		static const uint16_t IdleCoreAddr = 0x0000;		// The address that the idle core reads every cycle
+		FILE* write_log = nullptr;
+		size_t write_log_phi = 0;			// PHI counter of the last logged write
+		bool core_idle = false;
+		const RegWrite* replay = nullptr;
+		size_t replay_count = 0;
+		size_t replay_pos = 0;
+		size_t replay_phi = 0;				// PHI counter of the next replayed write
+		bool replay_active = false;			// The current PHI cycle is a replayed write
+
+		// Debug build: the HLE APU is checked against a gate-level APU that runs in lockstep with it (see sim_Lockstep).
+		// The gate-level APU does not simulate the core, it takes the core outputs from the HLE APU.
+
+		APU* lockstep = nullptr;
+		APU* leader = nullptr;
+		uint8_t core_DB = 0;				// DB right after the core
+
+		void sim_Lockstep(BaseLogic::TriState inputs[], BaseLogic::TriState outputs[], uint8_t data_in);
+
+		void sim_Stems();
+		void sim_AudioBlocks(AudioOutSignal& AUX);
+		void sim_WriteLog();
+
 		void sim_CoreIntegration();
 		void sim_SoundGenerators();
+		void sim_IdleChannels();
+
+		static ChipFeature GetRevisionFeatures(Revision rev);
 
 	public:
-		APU(M6502Core::M6502* core, Revision rev, ChipFeature features = ChipFeature::ByRevision);
+		/// <summary>
+		/// Create the APU.
+		/// </summary>
+		/// <param name="core">The 6502 core instance (created by the consumer)</param>
+		/// <param name="rev">APU revision</param>
+		/// <param name="features">ByRevision: take the features of the revision</param>
+		/// <param name="hle">true: simulate the registers, counters and LFSRs of the sound channels and the frame counter with integers. The output is the same as at the gate level, but it cannot be switched after the APU is created.</param>
+		APU(M6502Core::M6502* core, Revision rev, ChipFeature features = ChipFeature::ByRevision, bool hle = false);
 		~APU();
 
 		/// <summary>
@@ -986,6 +1290,58 @@ namespace APUSim
 		/// <param name="enable"></param>
 		void SetNormalizedOutput(bool enable);
 
+		/// <summary>
+		/// Do not simulate the sound channels that are silenced (the length counter is 0 or the channel is disabled by $4015) until the next write to their registers, $4015 access or frame counter event.
+		/// A sleeping channel keeps its outputs and simulates only the parts that run regardless of the length counter (the frequency counters, the duty counter and the LFSRs), so the result is the same as without the skip.
+		/// </summary>
+		/// <param name="enable"></param>
+		void SetIdleChannelSkip(bool enable);
+
+		/// <summary>
+		/// Write the DAC inputs of each sound channel to the caller buffers every PHI cycle.
+		/// </summary>
+		/// <param name="buffers">nullptr: stop writing</param>
+		void SetAudioStems(AudioStems* buffers);
+
+		/// <summary>
+		/// Collect the DAC output in blocks, instead of sampling it after each half cycle.
+		/// </summary>
+		/// <param name="blocks">nullptr: stop collecting</param>
+		void SetAudioBlocks(AudioBlocks* blocks);
+
+		/// <summary>
+		/// Get the DMA counters collected since the APU was created or the last ResetDMAStats.
+		/// </summary>
+		/// <param name="stats">The counters are 0 if the APU is built without APU_DMA_STATS</param>
+		/// <returns>false: the APU is built without APU_DMA_STATS</returns>
+		bool GetDMAStats(DMAStats& stats);
+
+		/// <summary>
+		/// Reset the DMA counters (e.g. at the beginning of each field).
+		/// </summary>
+		void ResetDMAStats();
+
+		/// <summary>
+		/// Write the $4000-$4017 writes of the core to a binary file (a sequence of RegWrite entries, timed from the moment the log is started).
+		/// </summary>
+		/// <param name="filename">nullptr: close the log</param>
+		/// <returns>false: the file could not be created</returns>
+		bool SetWriteLog(const char* filename);
+
+		/// <summary>
+		/// Do not simulate the 6502 core. The idle core reads the same address every cycle, only the replayed register writes are put on the bus (see SetWriteReplay).
+		/// </summary>
+		/// <param name="idle">true: hold the core idle</param>
+		void HoldCore(bool idle);
+
+		/// <summary>
+		/// Replay the register write log while the core is held idle. The log is timed from the moment of this call, so the replay should be started at the same point after power-on as the recording was.
+		/// The entries must stay valid until the replay is finished or replaced.
+		/// </summary>
+		/// <param name="entries">nullptr: stop the replay</param>
+		/// <param name="count">Number of entries</param>
+		void SetWriteReplay(const RegWrite* entries, size_t count);
+
 		/// <summary>
 		/// Get the value of the ACLK cycle counter (PHI/2)
 		/// </summary>
@@ -0,0 +1,111 @@
+/*
+ * breakscore - Famicom functional simulator.
+ *
+ * Copyright (C) 2024 org
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pch.h"
+
+using namespace BaseLogic;
+
+namespace Breaknes
+{
+	APUPlayerBoard::APUPlayerBoard(APUSim::Revision apu_rev, PPUSim::Revision ppu_rev, Mappers::ConnectorType p1) : Board(apu_rev, ppu_rev, p1)
+	{
+		// The core is still created, since it is a part of the APU, but it is not simulated.
+		// The sound channels are simulated in HLE mode: the output is the same, and the board is only used for the sound anyway.
+
+		core = new M6502Core::M6502(true, true);
+		apu = new APUSim::APU(core, apu_rev, APUSim::ChipFeature::ByRevision, true);
+
+		apu->SetNormalizedOutput(true);
+		apu->HoldCore(true);
+	}
+
+	APUPlayerBoard::~APUPlayerBoard()
+	{
+		EjectCartridge();
+		delete apu;
+		delete core;
+	}
+
+	void APUPlayerBoard::Step()
+	{
+		nRST = pendingReset ? TriState::Zero : TriState::One;
+
+		TriState inputs[(size_t)APUSim::APU_Input::Max]{};
+		TriState outputs[(size_t)APUSim::APU_Output::Max]{};
+
+		inputs[(size_t)APUSim::APU_Input::CLK] = CLK;
+		inputs[(size_t)APUSim::APU_Input::n_NMI] = vdd;
+		inputs[(size_t)APUSim::APU_Input::n_IRQ] = vdd;
+		inputs[(size_t)APUSim::APU_Input::n_RES] = nRST;
+		inputs[(size_t)APUSim::APU_Input::DBG] = TriState::Zero;
+
+		apu->sim(inputs, outputs, &data_bus, &addr_bus, aux);
+
+		// Tick
+
+		CLK = NOT(CLK);
+
+		if (pendingReset)
+		{
+			resetHalfClkCounter--;
+			if (resetHalfClkCounter == 0)
+			{
+				pendingReset = false;
+			}
+		}
+	}
+
+	int APUPlayerBoard::InsertCartridge(uint8_t* nesImage, size_t nesImageSize)
+	{
+		EjectCartridge();
+
+		if (nesImageSize % sizeof(APUSim::RegWrite) != 0)
+		{
+			return -2;
+		}
+
+		reg_log_size = nesImageSize / sizeof(APUSim::RegWrite);
+		reg_log = new APUSim::RegWrite[reg_log_size];
+		memcpy(reg_log, nesImage, nesImageSize);
+
+		apu->SetWriteReplay(reg_log, reg_log_size);
+		return 0;
+	}
+
+	void APUPlayerBoard::EjectCartridge()
+	{
+		apu->SetWriteReplay(nullptr, 0);
+
+		delete[] reg_log;
+		reg_log = nullptr;
+		reg_log_size = 0;
+		cart_slot_version++;
+	}
+
+	void APUPlayerBoard::Reset()
+	{
+		pendingReset = true;
+		resetHalfClkCounter = 64;
+	}
+
+	bool APUPlayerBoard::InResetState()
+	{
+		return pendingReset;
+	}
+}
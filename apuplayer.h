@@ -0,0 +1,58 @@
+/*
+ * breakscore - Famicom functional simulator.
+ *
+ * Copyright (C) 2024 org
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// A board with only the APU on it, for sound regression and playback.
+// The 6502 core is held idle and instead of a cartridge the board takes the APU register write log (see APUSim::APU::SetWriteLog), which is replayed at the recorded PHI cycles.
+// There is no PPU, VRAM or cartridge, so the DMC samples are read from the open bus.
+
+namespace Breaknes
+{
+	class APUPlayerBoard : public Board
+	{
+		APUSim::RegWrite* reg_log = nullptr;
+		size_t reg_log_size = 0;
+
+		BaseLogic::TriState nRST = BaseLogic::TriState::Z;
+
+		bool pendingReset = false;
+		int resetHalfClkCounter = 0;
+
+	public:
+		APUPlayerBoard(APUSim::Revision apu_rev, PPUSim::Revision ppu_rev, Mappers::ConnectorType p1);
+		virtual ~APUPlayerBoard();
+
+		void Step() override;
+
+		/// <summary>
+		/// "Insert" the register write log. The replay starts from the current PHI cycle.
+		/// </summary>
+		/// <param name="nesImage">The log file image (a sequence of APUSim::RegWrite entries)</param>
+		/// <param name="nesImageSize">Size of the log in bytes</param>
+		/// <returns>-2: the size is not a multiple of the entry size</returns>
+		int InsertCartridge(uint8_t* nesImage, size_t nesImageSize) override;
+
+		void EjectCartridge() override;
+
+		void Reset() override;
+
+		bool InResetState() override;
+	};
+}
@@ -420,15 +420,7 @@ namespace BaseLogic
 			}
 
 			outs = new TriState[maxLane * romOutputs];
-			TriState* outputs;
-
-			for (size_t n = 0; n < maxLane; n++)
-			{
-				sim_Unomptimized(n, &outputs);
-
-				TriState* lane = &outs[n * romOutputs];
-				memcpy(lane, outputs, romOutputs * sizeof(TriState));
-			}
+			GenerateLanes();
 
 			f = fopen(fname, "wb");
 			if (f)
@@ -443,6 +435,97 @@ namespace BaseLogic
 		}
 	}
 
+	void PLA::GenerateLanes()
+	{
+		// Output-major form of the matrix: the output is `1` when none of the inputs with a transistor is `1`.
+
+		terms = new size_t[romOutputs];
+		for (size_t out = 0; out < romOutputs; out++)
+		{
+			terms[out] = 0;
+			for (size_t bit = 0; bit < romInputs; bit++)
+			{
+				if (rom[out * romInputs + bit])
+				{
+					terms[out] |= 1ULL << bit;
+				}
+			}
+		}
+
+		// The lanes are split into chunks which are handed out to all cores. The calling thread reports the progress.
+
+		size_t maxLane = 1ULL << romInputs;
+		chunkCount = (maxLane + LanesPerChunk - 1) / LanesPerChunk;
+		nextChunk = 0;
+		chunksDone = 0;
+
+		size_t threadCount = std::thread::hardware_concurrency();
+		if (threadCount == 0)
+		{
+			threadCount = 1;
+		}
+		if (threadCount > chunkCount)
+		{
+			threadCount = chunkCount;
+		}
+
+		std::vector<std::thread> workers;
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			workers.push_back(std::thread(GenerateWorker, this));
+		}
+
+		size_t reported = 0;
+		printf("Generating %s (%zu threads)...\n", fname, threadCount);
+		while (chunksDone < chunkCount)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			size_t percent = chunksDone * 100 / chunkCount;
+			if (percent >= reported + 10)
+			{
+				reported = percent - percent % 10;
+				printf("%s: %zu%%\n", fname, reported);
+			}
+		}
+
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			workers[i].join();
+		}
+
+		delete[] terms;
+		terms = nullptr;
+	}
+
+	void PLA::GenerateWorker(PLA* pla)
+	{
+		size_t maxLane = 1ULL << pla->romInputs;
+		size_t outputsCount = pla->romOutputs;
+
+		while (true)
+		{
+			size_t chunk = pla->nextChunk++;
+			if (chunk >= pla->chunkCount)
+			{
+				break;
+			}
+
+			size_t first = chunk * LanesPerChunk;
+			size_t last = std::min(first + LanesPerChunk, maxLane);
+
+			for (size_t n = first; n < last; n++)
+			{
+				TriState* lane = &pla->outs[n * outputsCount];
+				for (size_t out = 0; out < outputsCount; out++)
+				{
+					lane[out] = (n & pla->terms[out]) ? TriState::Zero : TriState::One;
+				}
+			}
+
+			pla->chunksDone++;
+		}
+	}
+
 	void PLA::sim(size_t input_bits, TriState** outputs)
 	{
 		if (!outs)
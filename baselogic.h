@@ -360,6 +360,17 @@ namespace BaseLogic
 		bool Optimize = true;
 		char fname[0x100] = { 0 };
 
+		// Generation of the lanes for the optimized mode (all cores, see GenerateLanes)
+
+		static const size_t LanesPerChunk = 0x4000;
+		size_t* terms = nullptr;			// Output-major matrix: the bits of the inputs that ground the output
+		size_t chunkCount = 0;
+		std::atomic<size_t> nextChunk{ 0 };
+		std::atomic<size_t> chunksDone{ 0 };
+
+		void GenerateLanes();
+		static void GenerateWorker(PLA* pla);
+
 	public:
 		PLA(size_t inputs, size_t outputs, char* filename);
 		~PLA();
@@ -37,6 +37,7 @@ namespace Breaknes
 	{
 		Mappers::CartridgeFactory cf(p1_type, nesImage, nesImageSize);
 		cart = cf.GetInstance();
+		cart_slot_version++;
 
 		if (!cart)
 			return -1;
@@ -59,6 +60,7 @@ namespace Breaknes
 			delete cart;
 			cart = nullptr;
 		}
+		cart_slot_version++;
 	}
 
 	void Board::Reset()
@@ -82,19 +84,27 @@ namespace Breaknes
 
 	void Board::SampleAudioSignal(float* sample)
 	{
-		// NES/Famicom motherboards have some analog circuitry that acts as a LPF/HPF. Now the sound from the simulator comes without filtering, so there may be some ear-unpleasant harmonics.
-		// TBD: Add LPF/HPF
-
 		if (sample != nullptr)
 		{
-			// There are 2 resistors (12k and 20k) on the motherboard that equalize the AUX A/B levels and then mix.
-			// Although the internal resistance of the AUX A/B terminals inside the APU we counted with the 100 ohm pull-ups -- the above 2 resistors are part of the "Board", so they count here.
+			MixAudioSignal(&aux, nullptr, sample, 1);
+		}
+	}
 
-			*sample = (aux.normalized.a * 0.4f /* 20k resistor */ + aux.normalized.b /* 12k resistor */) / 2.0f;
+	void Board::MixAudioSignal(const APUSim::AudioOutSignal* aux, const float* cart, float* samples, size_t count)
+	{
+		// NES/Famicom motherboards have some analog circuitry that acts as a LPF/HPF. Now the sound from the simulator comes without filtering, so there may be some ear-unpleasant harmonics.
+		// TBD: Add LPF/HPF
+
+		// There are 2 resistors (12k and 20k) on the motherboard that equalize the AUX A/B levels and then mix.
+		// Although the internal resistance of the AUX A/B terminals inside the APU we counted with the 100 ohm pull-ups -- the above 2 resistors are part of the "Board", so they count here.
 
-			// This is essentially "muting" AUX A, because the level of AUX A at its peak is about 300 mV, and the level of AUX B at its peak is about 1100 mV.
-			// Accordingly, if you do just (A+B)/2, the square channels will be "overshoot".
+		for (size_t n = 0; n < count; n++)
+		{
+			samples[n] = (aux[n].normalized.a * 0.4f /* 20k resistor */ + aux[n].normalized.b /* 12k resistor */) / 2.0f;
 		}
+
+		// This is essentially "muting" AUX A, because the level of AUX A at its peak is about 300 mV, and the level of AUX B at its peak is about 1100 mV.
+		// Accordingly, if you do just (A+B)/2, the square channels will be "overshoot".
 	}
 
 	void Board::GetApuSignalFeatures(APUSim::AudioSignalFeatures* features)
@@ -106,7 +116,7 @@ namespace Breaknes
 
 	size_t Board::GetPCLKCounter()
 	{
-		return ppu->GetPCLKCounter();
+		return ppu != nullptr ? ppu->GetPCLKCounter() : 0;
 	}
 
 	void Board::SampleVideoSignal(PPUSim::VideoOutSignal* sample)
@@ -119,24 +129,27 @@ namespace Breaknes
 
 	size_t Board::GetHCounter()
 	{
-		return ppu->GetHCounter();
+		return ppu != nullptr ? ppu->GetHCounter() : 0;
 	}
 
 	size_t Board::GetVCounter()
 	{
-		return ppu->GetVCounter();
+		return ppu != nullptr ? ppu->GetVCounter() : 0;
 	}
 
 	void Board::GetPpuSignalFeatures(PPUSim::VideoSignalFeatures* features)
 	{
 		PPUSim::VideoSignalFeatures feat{};
-		ppu->GetSignalFeatures(feat);
+		if (ppu != nullptr)
+		{
+			ppu->GetSignalFeatures(feat);
+		}
 		*features = feat;
 	}
 
 	void Board::ConvertRAWToRGB(uint16_t raw, uint8_t* r, uint8_t* g, uint8_t* b)
 	{
-		if (!pal_cached)
+		if (!pal_cached && ppu != nullptr)
 		{
 			PPUSim::VideoOutSignal rawIn{}, rgbOut{};
 
@@ -163,17 +176,124 @@ namespace Breaknes
 
 	void Board::SetRAWColorMode(bool enable)
 	{
-		ppu->SetRAWOutput(enable);
+		if (ppu != nullptr)
+		{
+			ppu->SetRAWOutput(enable);
+		}
 	}
 
 	void Board::SetOamDecayBehavior(PPUSim::OAMDecayBehavior behavior)
 	{
-		ppu->SetOamDecayBehavior(behavior);
+		if (ppu != nullptr)
+		{
+			ppu->SetOamDecayBehavior(behavior);
+		}
 	}
 
 	void Board::SetNoiseLevel(float volts)
 	{
-		ppu->SetCompositeNoise(volts);
+		if (ppu != nullptr)
+		{
+			ppu->SetCompositeNoise(volts);
+		}
+	}
+
+	void Board::SetDetailedPPUBus(bool enable)
+	{
+		ppu_bus_detailed = enable;
+	}
+
+	void Board::SetFastCPU(bool enable)
+	{
+		if (core != nullptr)
+		{
+			core->SetFastMode(enable);
+		}
+	}
+
+	void Board::SetCPUCommandCache(bool enable, bool validate)
+	{
+		if (core != nullptr)
+		{
+			core->SetCommandCache(enable, validate);
+		}
+	}
+
+	void Board::SetCPUTrace(size_t entries, char* sink_filename)
+	{
+		if (core != nullptr)
+		{
+			core->SetTrace(entries);
+			if (core->GetTrace() != nullptr && sink_filename != nullptr)
+			{
+				core->GetTrace()->SetSink(sink_filename, 0x1000);
+			}
+		}
+	}
+
+	void Board::DumpCPUTrace(char* filename, size_t count)
+	{
+		if (core != nullptr && core->GetTrace() != nullptr)
+		{
+			FILE* f = fopen(filename, "wt");
+			if (f)
+			{
+				core->GetTrace()->Dump(f, count);
+				fclose(f);
+			}
+		}
+	}
+
+	void Board::SetAPUIdleChannelSkip(bool enable)
+	{
+		if (apu != nullptr)
+		{
+			apu->SetIdleChannelSkip(enable);
+		}
+	}
+
+	void Board::SetAudioStems(APUSim::AudioStems* buffers)
+	{
+		if (apu != nullptr)
+		{
+			apu->SetAudioStems(buffers);
+		}
+	}
+
+	void Board::SetAudioBlocks(APUSim::AudioBlocks* blocks)
+	{
+		audio_blocks = blocks;
+
+		if (apu != nullptr)
+		{
+			apu->SetAudioBlocks(blocks);
+		}
+	}
+
+	bool Board::GetAPUDMAStats(APUSim::DMAStats* stats)
+	{
+		if (apu != nullptr)
+		{
+			return apu->GetDMAStats(*stats);
+		}
+		return false;
+	}
+
+	void Board::ResetAPUDMAStats()
+	{
+		if (apu != nullptr)
+		{
+			apu->ResetDMAStats();
+		}
+	}
+
+	bool Board::SetAPUWriteLog(char* filename)
+	{
+		if (apu != nullptr)
+		{
+			return apu->SetWriteLog(filename);
+		}
+		return false;
 	}
 
 	BoardFactory::BoardFactory(std::string board, std::string apu, std::string ppu, std::string p1)
@@ -317,10 +437,10 @@ namespace Breaknes
 		//{
 		//	inst = new NESBoard(apu_rev, ppu_rev, p1_type);
 		//}
-		//else if (board_name == "APUPlayer")
-		//{
-		//	inst = new APUPlayerBoard(apu_rev, ppu_rev, p1_type);
-		//}
+		else if (board_name == "APUPlayer")
+		{
+			inst = new APUPlayerBoard(apu_rev, ppu_rev, p1_type);
+		}
 		//else if (board_name == "PPUPlayer")
 		//{
 		//	inst = new PPUPlayerBoard(apu_rev, ppu_rev, p1_type);
@@ -52,12 +52,18 @@ namespace Breaknes
 		uint16_t addr_bus = 0;
 
 		APUSim::AudioOutSignal aux{};
+		APUSim::AudioBlocks* audio_blocks = nullptr;
 		PPUSim::VideoOutSignal vidSample{};
 
 		// The cartridge slot supports hotplugging during simulation.
 
 		Mappers::AbstractCartridge* cart = nullptr;
 		Mappers::ConnectorType p1_type = Mappers::ConnectorType::None;
+		size_t cart_slot_version = 0;		// Incremented every time the cartridge is inserted or ejected
+
+		// Simulate the PPU bus (address latch, cartridge CHR, VRAM) in full instead of accessing the memory directly.
+
+		bool ppu_bus_detailed = false;
 
 		// Pre-calculated PPU palette
 
@@ -123,6 +129,15 @@ namespace Breaknes
 		/// <returns></returns>
 		virtual void SampleAudioSignal(float* sample);
 
+		/// <summary>
+		/// Mix the normalized AUX A/B values and the cartridge sound into the resulting board sound, the same way as SampleAudioSignal does.
+		/// </summary>
+		/// <param name="aux">The APU output (e.g. a block from APUSim::AudioBlocks)</param>
+		/// <param name="cart">The cartridge sound of each sample (APUSim::AudioBlocks::cart). nullptr: take the current cartridge sound</param>
+		/// <param name="samples">Resulting samples in the normalized [0.0; 1.0] format</param>
+		/// <param name="count">Number of samples</param>
+		virtual void MixAudioSignal(const APUSim::AudioOutSignal* aux, const float* cart, float* samples, size_t count);
+
 		/// <summary>
 		/// Get audio signal settings that help with its rendering on the consumer side.
 		/// </summary>
@@ -182,6 +197,75 @@ namespace Breaknes
 		/// </summary>
 		/// <param name="volts"></param>
 		virtual void SetNoiseLevel(float volts);
+
+		/// <summary>
+		/// Select how the PPU bus is simulated.
+		/// By default, PPU reads and writes go directly to CHR/VRAM through the cartridge memory map. The detailed mode simulates the address latch, the cartridge and the VRAM chip as separate parts (useful for bus conflict research).
+		/// </summary>
+		/// <param name="enable">true: detailed PPU bus simulation</param>
+		virtual void SetDetailedPPUBus(bool enable);
+
+		/// <summary>
+		/// Select how the 6502 core is simulated.
+		/// In fast mode the core runs an instruction-level engine between the instruction boundaries and falls back to the gate-level simulation on /RES. The bus activity is the same.
+		/// </summary>
+		/// <param name="enable">true: fast mode</param>
+		virtual void SetFastCPU(bool enable);
+
+		/// <summary>
+		/// Cache the control commands of the 6502 random logic for the repeating states of the control unit.
+		/// </summary>
+		/// <param name="enable">true: use the cache</param>
+		/// <param name="validate">true: check each cached result against the simulation (debug)</param>
+		virtual void SetCPUCommandCache(bool enable, bool validate);
+
+		/// <summary>
+		/// Enable the 6502 instruction trace.
+		/// </summary>
+		/// <param name="entries">Size of the ring buffer (0: disable the trace)</param>
+		/// <param name="sink_filename">If not nullptr, the binary records are also streamed to this file</param>
+		virtual void SetCPUTrace(size_t entries, char* sink_filename);
+
+		/// <summary>
+		/// Save the last records of the 6502 instruction trace as text.
+		/// </summary>
+		virtual void DumpCPUTrace(char* filename, size_t count);
+
+		/// <summary>
+		/// Do not simulate the APU sound channels while they are silenced (see APU::SetIdleChannelSkip). The output is the same as without the skip.
+		/// </summary>
+		/// <param name="enable">true: skip the idle channels</param>
+		virtual void SetAPUIdleChannelSkip(bool enable);
+
+		/// <summary>
+		/// Write the DAC inputs of each APU sound channel to the caller buffers every PHI cycle (see APUSim::AudioStems).
+		/// </summary>
+		/// <param name="buffers">nullptr: stop writing</param>
+		virtual void SetAudioStems(APUSim::AudioStems* buffers);
+
+		/// <summary>
+		/// Collect the APU output in blocks (see APUSim::AudioBlocks).
+		/// </summary>
+		/// <param name="blocks">nullptr: stop collecting</param>
+		virtual void SetAudioBlocks(APUSim::AudioBlocks* blocks);
+
+		/// <summary>
+		/// Get the APU DMA counters (see APUSim::DMAStats).
+		/// </summary>
+		/// <returns>false: there is no APU or it is built without APU_DMA_STATS</returns>
+		virtual bool GetAPUDMAStats(APUSim::DMAStats* stats);
+
+		/// <summary>
+		/// Reset the APU DMA counters.
+		/// </summary>
+		virtual void ResetAPUDMAStats();
+
+		/// <summary>
+		/// Write the APU register writes ($4000-$4017) to a binary log, which can be played on the APUPlayer board.
+		/// </summary>
+		/// <param name="filename">nullptr: close the log</param>
+		/// <returns>false: the file could not be created</returns>
+		virtual bool SetAPUWriteLog(char* filename);
 	};
 
 	class BoardFactory
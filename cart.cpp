@@ -35,6 +35,16 @@ namespace Mappers
 		return true;
 	}
 
+	bool AbstractCartridge::GetPPUMemoryMap(PPUMemoryMap& map)
+	{
+		return false;
+	}
+
+	size_t AbstractCartridge::GetPPUMemoryMapVersion()
+	{
+		return ppu_map_version;
+	}
+
 	CartridgeFactory::CartridgeFactory(ConnectorType p1, uint8_t* nesImage, size_t size)
 	{
 		p1_type = p1;
@@ -64,6 +64,17 @@ namespace Mappers
 		float normalized;
 	};
 
+	/// <summary>
+	/// The PPU address space as seen from the cartridge connector, in 1 KByte pages.
+	/// Used by the motherboard to access CHR and VRAM directly, bypassing the simulation of the PPU bus.
+	/// </summary>
+	struct PPUMemoryMap
+	{
+		uint8_t* chr[8];			// CHR pages $0000-$1FFF. nullptr: nothing responds
+		bool chr_writable[8];		// CHR RAM
+		int vram_a10[8];			// VRAM_A10 value for the pages $2000-$3FFF. -1: VRAM is not selected (/VRAM_CS = 1)
+	};
+
 	class AbstractCartridge
 	{
 	protected:
@@ -72,6 +83,8 @@ namespace Mappers
 		BaseLogic::TriState gnd = BaseLogic::TriState::Zero;
 		BaseLogic::TriState vdd = BaseLogic::TriState::One;
 
+		size_t ppu_map_version = 0;		// Must be incremented by the mapper every time it changes CHR banking or mirroring
+
 	public:
 		AbstractCartridge(ConnectorType _p1_type, uint8_t* nesImage, size_t size);
 		virtual ~AbstractCartridge();
@@ -89,6 +102,18 @@ namespace Mappers
 			CartAudioOutSignal* snd_out,
 			// NES only
 			uint16_t* exp, bool& exp_dirty) = 0;
+
+		/// <summary>
+		/// Get the current PPU memory map of the cartridge.
+		/// </summary>
+		/// <param name="map">Filled with the CHR pages and nametable mirroring.</param>
+		/// <returns>false: The mapper does not support direct access and its PPU part must always be simulated.</returns>
+		virtual bool GetPPUMemoryMap(PPUMemoryMap& map);
+
+		/// <summary>
+		/// The PPU memory map only needs to be requested again when this value changes.
+		/// </summary>
+		size_t GetPPUMemoryMapVersion();
 	};
 
 	class CartridgeFactory
@@ -133,6 +133,22 @@ extern "C"
 		}
 	}
 
+	void SetAudioBlocks(APUSim::AudioBlocks* blocks)
+	{
+		if (board != nullptr)
+		{
+			board->SetAudioBlocks(blocks);
+		}
+	}
+
+	void MixAudioSignal(const APUSim::AudioOutSignal* aux, const float* cart, float* samples, size_t count)
+	{
+		if (board != nullptr)
+		{
+			board->MixAudioSignal(aux, cart, samples, count);
+		}
+	}
+
 	size_t GetPCLKCounter()
 	{
 		if (board != nullptr)
@@ -234,6 +250,88 @@ extern "C"
 		}
 	}
 
+	void SetDetailedPPUBus(bool enable)
+	{
+		if (board != nullptr)
+		{
+			board->SetDetailedPPUBus(enable);
+		}
+	}
+
+	void SetFastCPU(bool enable)
+	{
+		if (board != nullptr)
+		{
+			board->SetFastCPU(enable);
+		}
+	}
+
+	void SetCPUCommandCache(bool enable, bool validate)
+	{
+		if (board != nullptr)
+		{
+			board->SetCPUCommandCache(enable, validate);
+		}
+	}
+
+	void SetCPUTrace(size_t entries, char* sink_filename)
+	{
+		if (board != nullptr)
+		{
+			board->SetCPUTrace(entries, sink_filename);
+		}
+	}
+
+	void DumpCPUTrace(char* filename, size_t count)
+	{
+		if (board != nullptr)
+		{
+			board->DumpCPUTrace(filename, count);
+		}
+	}
+
+	void SetAPUIdleChannelSkip(bool enable)
+	{
+		if (board != nullptr)
+		{
+			board->SetAPUIdleChannelSkip(enable);
+		}
+	}
+
+	void SetAudioStems(APUSim::AudioStems* buffers)
+	{
+		if (board != nullptr)
+		{
+			board->SetAudioStems(buffers);
+		}
+	}
+
+	bool GetAPUDMAStats(APUSim::DMAStats* stats)
+	{
+		if (board != nullptr)
+		{
+			return board->GetAPUDMAStats(stats);
+		}
+		return false;
+	}
+
+	void ResetAPUDMAStats()
+	{
+		if (board != nullptr)
+		{
+			board->ResetAPUDMAStats();
+		}
+	}
+
+	bool SetAPUWriteLog(char* filename)
+	{
+		if (board != nullptr)
+		{
+			return board->SetAPUWriteLog(filename);
+		}
+		return false;
+	}
+
 	size_t IOCreateInstance(uint32_t device_id)
 	{
 		if (board != nullptr && board->io != nullptr)
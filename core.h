@@ -89,6 +89,18 @@ extern "C"
 	/// <param name="features"></param>
 	void GetApuSignalFeatures(APUSim::AudioSignalFeatures* features);
 
+	/// <summary>
+	/// Collect the APU output in blocks at the native sample rate (see GetApuSignalFeatures), instead of calling SampleAudioSignal after each Step. The blocks are mixed into the board sound with MixAudioSignal.
+	/// </summary>
+	/// <param name="blocks">nullptr: stop collecting</param>
+	void SetAudioBlocks(APUSim::AudioBlocks* blocks);
+
+	/// <summary>
+	/// Mix the APU output (e.g. a block collected by SetAudioBlocks) into the resulting board sound in normalized [0.0; 1.0] format, the same as SampleAudioSignal gives.
+	/// </summary>
+	/// <param name="cart">The cartridge sound of each sample (APUSim::AudioBlocks::cart). nullptr: take the current cartridge sound</param>
+	void MixAudioSignal(const APUSim::AudioOutSignal* aux, const float* cart, float* samples, size_t count);
+
 	/// <summary>
 	/// Get the "pixel" counter. Keep in mind that pixels refers to an abstract entity representing the visible or invisible part of the video signal.
 	/// </summary>
@@ -143,6 +155,71 @@ extern "C"
 	/// <param name="volts"></param>
 	void SetNoiseLevel(float volts);
 
+	/// <summary>
+	/// Select how the PPU bus is simulated.
+	/// By default, PPU reads and writes go directly to CHR/VRAM through the cartridge memory map. The detailed mode simulates the address latch, the cartridge and the VRAM chip as separate parts (useful for bus conflict research).
+	/// </summary>
+	/// <param name="enable">true: detailed PPU bus simulation</param>
+	void SetDetailedPPUBus(bool enable);
+
+	/// <summary>
+	/// Select how the 6502 core is simulated.
+	/// In fast mode the core runs an instruction-level engine between the instruction boundaries and falls back to the gate-level simulation on /RES. The bus activity is the same as in the gate-level mode with some exceptions: the dummy reads while /RES = 0 may differ (e.g. /RES during an interrupt sequence or a JAM gives other addresses), a falling edge of SO is ignored while the fast engine is running, and the address of an unstable store (SHA, SHX, SHY, TAS) stalled by RDY may differ.
+	/// </summary>
+	/// <param name="enable">true: fast mode</param>
+	void SetFastCPU(bool enable);
+
+	/// <summary>
+	/// Cache the control commands of the 6502 random logic for the repeating states of the control unit.
+	/// </summary>
+	/// <param name="enable">true: use the cache</param>
+	/// <param name="validate">true: check each cached result against the simulation (debug)</param>
+	void SetCPUCommandCache(bool enable, bool validate);
+
+	/// <summary>
+	/// Enable the 6502 instruction trace (a ring buffer of the last executed instructions).
+	/// </summary>
+	/// <param name="entries">Size of the ring buffer (0: disable the trace)</param>
+	/// <param name="sink_filename">If not nullptr, the binary records are also streamed to this file</param>
+	void SetCPUTrace(size_t entries, char* sink_filename);
+
+	/// <summary>
+	/// Save the last records of the 6502 instruction trace as text.
+	/// </summary>
+	void DumpCPUTrace(char* filename, size_t count);
+
+	/// <summary>
+	/// Do not simulate the APU sound channels while they are silenced. The output is the same as without the skip.
+	/// </summary>
+	/// <param name="enable">true: skip the idle channels</param>
+	void SetAPUIdleChannelSkip(bool enable);
+
+	/// <summary>
+	/// Write the DAC inputs of each APU sound channel (SQA, SQB, TRI, RND, DMC) to the caller buffers every PHI cycle, optionally run-length encoded. The caller drains the buffers by resetting `count`.
+	/// </summary>
+	/// <param name="buffers">nullptr: stop writing</param>
+	void SetAudioStems(APUSim::AudioStems* buffers);
+
+	/// <summary>
+	/// Get the number of PHI cycles the CPU was halted by the OAM DMA and the DMC fetches, the number of the DMAs and of the DMC interrupts, counted since the last ResetAPUDMAStats.
+	/// The counters are only collected when the APU is built with APU_DMA_STATS=1.
+	/// </summary>
+	/// <returns>false: the counters are not available</returns>
+	bool GetAPUDMAStats(APUSim::DMAStats* stats);
+
+	/// <summary>
+	/// Reset the APU DMA counters (e.g. at the beginning of each field).
+	/// </summary>
+	void ResetAPUDMAStats();
+
+	/// <summary>
+	/// Write the APU register writes ($4000-$4017) to a binary log. The log is played by the "APUPlayer" board, which takes it instead of the .nes image in InsertCartridge.
+	/// Start the log at the same point after power-on as the playback will be started (e.g. right after CreateBoard), so that the frame counter and the channels are in the same phase.
+	/// </summary>
+	/// <param name="filename">nullptr: close the log</param>
+	/// <returns>false: the file could not be created</returns>
+	bool SetAPUWriteLog(char* filename);
+
 	/// <summary>
 	/// Create an IO instance of the device with the specified DeviceID. Return handle
 	/// </summary>
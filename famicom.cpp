@@ -32,7 +32,7 @@ namespace Breaknes
 		// Big chips
 		core = new M6502Core::M6502(true, true);
 		apu = new APUSim::APU(core, apu_rev);
-		ppu = new PPUSim::PPU(ppu_rev);
+		ppu = new PPUSim::PPU(ppu_rev, false, true);
 
 		// Memory
 		wram = new BaseBoard::SRAM("WRAM", wram_bits);
@@ -148,8 +148,22 @@ namespace Breaknes
 
 		// Cartridge In
 
+		bool fast_ppu_bus = PPUBusFastPath();
 		bool LatchOutZ = false;
-		PPUAddrLatch.sim(PPU_ALE, TriState::Zero, ad_bus, &LatchedAddr, LatchOutZ);
+
+		if (fast_ppu_bus)
+		{
+			// The latch output is always enabled, so only its transparent phase matters.
+
+			if (PPU_ALE == TriState::One)
+			{
+				PPUAddrLatch.sim(PPU_ALE, TriState::Zero, ad_bus, &LatchedAddr, LatchOutZ);
+			}
+		}
+		else
+		{
+			PPUAddrLatch.sim(PPU_ALE, TriState::Zero, ad_bus, &LatchedAddr, LatchOutZ);
+		}
 
 		ppu_addr = ((uint16_t)pa8_13 << 8) | LatchedAddr;
 		PPU_nA13 = NOT(FromByte((ppu_addr >> 13) & 1));
@@ -163,8 +177,10 @@ namespace Breaknes
 
 			bool unused;
 
-			cart_in[(size_t)Mappers::CartInput::nRD] = PPU_nRD;
-			cart_in[(size_t)Mappers::CartInput::nWR] = PPU_nWR;
+			// In the fast path the PPU part of the cartridge is served by the board, the cartridge only sees the CPU bus.
+
+			cart_in[(size_t)Mappers::CartInput::nRD] = fast_ppu_bus ? TriState::One : PPU_nRD;
+			cart_in[(size_t)Mappers::CartInput::nWR] = fast_ppu_bus ? TriState::One : PPU_nWR;
 			cart_in[(size_t)Mappers::CartInput::nPA13] = PPU_nA13;
 			cart_in[(size_t)Mappers::CartInput::M2] = M2;
 			cart_in[(size_t)Mappers::CartInput::nROMSEL] = nROMSEL;
@@ -187,6 +203,13 @@ namespace Breaknes
 
 			VRAM_nCE = cart_out[(size_t)Mappers::CartOutput::VRAM_nCS];
 			VRAM_A10 = cart_out[(size_t)Mappers::CartOutput::VRAM_A10];
+
+			// The cartridge sound goes into the same sample of the audio block as the APU output of this half cycle.
+
+			if (audio_blocks != nullptr && audio_blocks->cart[0] != nullptr)
+			{
+				audio_blocks->cart[audio_blocks->current][audio_blocks->fill - 1] = cart_snd.normalized;
+			}
 		}
 		else
 		{
@@ -200,13 +223,20 @@ namespace Breaknes
 
 		// Memory
 
-		VRAM_Addr = LatchedAddr;
-		VRAM_Addr |= ((ppu_addr >> 8) & 1) << 8;
-		VRAM_Addr |= ((ppu_addr >> 9) & 1) << 9;
-		VRAM_Addr |= ((VRAM_A10 == TriState::One) ? 1 : 0) << 10;
+		if (fast_ppu_bus)
+		{
+			PPUBusDirectAccess();
+		}
+		else
+		{
+			VRAM_Addr = LatchedAddr;
+			VRAM_Addr |= ((ppu_addr >> 8) & 1) << 8;
+			VRAM_Addr |= ((ppu_addr >> 9) & 1) << 9;
+			VRAM_Addr |= ((VRAM_A10 == TriState::One) ? 1 : 0) << 10;
 
-		bool dz = (PPU_nRD == TriState::One && PPU_nWR == TriState::One);
-		vram->sim(VRAM_nCE, PPU_nWR, PPU_nRD, &VRAM_Addr, &ad_bus, dz);
+			bool dz = (PPU_nRD == TriState::One && PPU_nWR == TriState::One);
+			vram->sim(VRAM_nCE, PPU_nWR, PPU_nRD, &VRAM_Addr, &ad_bus, dz);
+		}
 
 		WRAM_Addr = addr_bus & (wram_size - 1);
 		wram->sim(WRAM_nCE, CPU_RnW, TriState::Zero, &WRAM_Addr, &data_bus, data_bus_dirty);
@@ -239,19 +269,19 @@ namespace Breaknes
 		return pendingReset;
 	}
 
-	void FamicomBoard::SampleAudioSignal(float* sample)
+	void FamicomBoard::MixAudioSignal(const APUSim::AudioOutSignal* aux, const float* cart, float* samples, size_t count)
 	{
 		// We do everything the same as in the base class, but with the sound from the cartridge taken into account.
 
 		// TODO: Mike
 		// TODO: Expansion port sound
 
-		if (sample != nullptr)
+		for (size_t n = 0; n < count; n++)
 		{
-			*sample = (
-				aux.normalized.a * 0.4f /* 20k resistor */ +
-				aux.normalized.b /* 12k resistor */ +
-				cart_snd.normalized /* levels pls, someone? */) / 3.0f;
+			samples[n] = (
+				aux[n].normalized.a * 0.4f /* 20k resistor */ +
+				aux[n].normalized.b /* 12k resistor */ +
+				(cart != nullptr ? cart[n] : cart_snd.normalized) /* levels pls, someone? */) / 3.0f;
 		}
 	}
 
@@ -335,6 +365,84 @@ namespace Breaknes
 		// And here you can add some dirt on the contacts
 	}
 
+	/// <summary>
+	/// Check whether the PPU bus can be served directly from the cartridge memory map.
+	/// </summary>
+	bool FamicomBoard::PPUBusFastPath()
+	{
+		if (ppu_bus_detailed || cart == nullptr)
+		{
+			return false;
+		}
+
+		if (ppu_map_slot_version != cart_slot_version)
+		{
+			ppu_map_slot_version = cart_slot_version;
+			UpdatePPUPages();
+		}
+
+		return ppu_map_valid;
+	}
+
+	void FamicomBoard::UpdatePPUPages()
+	{
+		Mappers::PPUMemoryMap map{};
+
+		ppu_map_version = cart->GetPPUMemoryMapVersion();
+		ppu_map_valid = cart->GetPPUMemoryMap(map);
+
+		if (!ppu_map_valid)
+		{
+			return;
+		}
+
+		uint8_t* vram_mem = vram->GetMemory();
+
+		for (size_t n = 0; n < 8; n++)
+		{
+			// $0000-$1FFF: CHR
+
+			ppu_pages[n] = map.chr[n];
+			ppu_pages_writable[n] = map.chr_writable[n];
+
+			// $2000-$3FFF: VRAM (VRAM_A10 is driven by the cartridge, A0-A9 come directly from the PPU)
+
+			ppu_pages[8 + n] = map.vram_a10[n] < 0 ? nullptr : &vram_mem[map.vram_a10[n] << 10];
+			ppu_pages_writable[8 + n] = true;
+		}
+	}
+
+	/// <summary>
+	/// PPU bus cycle without the simulation of the individual parts. Bus conflicts are not taken into account.
+	/// </summary>
+	void FamicomBoard::PPUBusDirectAccess()
+	{
+		if (cart->GetPPUMemoryMapVersion() != ppu_map_version)
+		{
+			UpdatePPUPages();
+		}
+
+		size_t page = (ppu_addr >> 10) & 0xf;
+		uint8_t* mem = ppu_pages[page];
+
+		if (mem == nullptr)
+		{
+			return;
+		}
+
+		if (PPU_nWR == TriState::Zero)
+		{
+			if (ppu_pages_writable[page])
+			{
+				mem[ppu_addr & 0x3ff] = ad_bus;
+			}
+		}
+		else if (PPU_nRD == TriState::Zero)
+		{
+			ad_bus = mem[ppu_addr & 0x3ff];
+		}
+	}
+
 #pragma region "Fami IO"
 
 	FamicomBoardIO::FamicomBoardIO(FamicomBoard* board) : IO::IOSubsystem()
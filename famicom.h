@@ -77,6 +77,15 @@ namespace Breaknes
 		uint8_t pa8_13 = 0;				// addr high bits
 		uint16_t ppu_addr = 0;			// To cartridge
 
+		// PPU bus fast path: the PPU address space mapped to the host memory in 1 KByte pages.
+		// The pages are rebuilt only when the cartridge is replaced or changes its memory map.
+
+		uint8_t* ppu_pages[16]{};
+		bool ppu_pages_writable[16]{};
+		bool ppu_map_valid = false;
+		size_t ppu_map_slot_version = 0;
+		size_t ppu_map_version = 0;
+
 		// Other wires
 
 		BaseLogic::TriState CPU_RnW = BaseLogic::TriState::X;
@@ -120,6 +129,10 @@ namespace Breaknes
 		void CartridgeConnectorSimFailure1();
 		void CartridgeConnectorSimFailure2();
 
+		bool PPUBusFastPath();
+		void UpdatePPUPages();
+		void PPUBusDirectAccess();
+
 	public:
 		FamicomBoard(APUSim::Revision apu_rev, PPUSim::Revision ppu_rev, Mappers::ConnectorType p1);
 		virtual ~FamicomBoard();
@@ -130,6 +143,6 @@ namespace Breaknes
 
 		bool InResetState() override;
 
-		void SampleAudioSignal(float* sample);
+		void MixAudioSignal(const APUSim::AudioOutSignal* aux, const float* cart, float* samples, size_t count);
 	};
 }
\ No newline at end of file
@@ -40,7 +40,6 @@ int SDLCALL MainWorker(void* data)
 			PPUSim::VideoOutSignal sample;
 			SampleVideoSignal(&sample);
 			vid_out->ProcessSample(sample);
-			snd_out->FeedSample();
 #endif
 		}
 	}
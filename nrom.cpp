@@ -81,6 +81,17 @@ namespace Mappers
 		return valid;
 	}
 
+	bool NROM::GetPPUMemoryMap(PPUMemoryMap& map)
+	{
+		for (size_t n = 0; n < 8; n++)
+		{
+			map.chr[n] = &CHR[n * 0x400];
+			map.chr_writable[n] = chr_ram;
+			map.vram_a10[n] = V_Mirroring ? (n & 1) : ((n >> 1) & 1);
+		}
+		return true;
+	}
+
 	void NROM::sim(
 		TriState cart_in[(size_t)CartInput::Max],
 		TriState cart_out[(size_t)CartOutput::Max],
@@ -33,6 +33,10 @@
 #include <iostream>
 #include <string>
 #include <list>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
 
 #pragma warning(disable: 26812)		// warning C26812: The enum type 'BaseLogic::TriState' is unscoped. Prefer 'enum class' over 'enum' (Enum.3).
 
@@ -51,6 +55,8 @@
 #include "ls373.h"
 #include "sram.h"
 #include "6502.h"
+#include "6502fast.h"
+#include "6502trace.h"
 #include "apu.h"
 #include "ppu.h"
 #include "cd4021.h"
@@ -64,6 +70,7 @@
 #include "unrom.h"
 #include "board.h"
 #include "famicom.h"
+#include "apuplayer.h"
 #include "core.h"
 #include "sound.h"
 #include "video.h"
\ No newline at end of file
@@ -25,9 +25,17 @@ namespace PPUSim
 {
 	// Background Color (BG COL)
 
-	BGCol::BGCol(PPU* parent)
+	BGCol::BGCol(PPU* parent, bool hle_mode)
 	{
 		ppu = parent;
+		HLE = hle_mode;
+
+		// The output latches of the shift register bits are in the inverse logic and are reset to 0.
+
+		for (size_t n = 0; n < 4; n++)
+		{
+			hle.out[n] = 0xffff;
+		}
 	}
 
 	BGCol::~BGCol()
@@ -35,6 +43,21 @@ namespace PPUSim
 	}
 
 	void BGCol::sim()
+	{
+		if (HLE)
+		{
+#if _DEBUG
+			sim_Lockstep();
+#else
+			sim_HLE();
+#endif
+			return;
+		}
+
+		sim_Gates();
+	}
+
+	void BGCol::sim_Gates()
 	{
 		sim_Control();
 		sim_BGC0();
@@ -181,6 +204,152 @@ namespace PPUSim
 		ppu->wire.BGC[3] = NOR(bgc3_latch[1].get(), clip);
 	}
 
+	void BGCol::sim_HLE()
+	{
+		bool PCLK = ppu->wire.PCLK == TriState::One;
+		bool n_PCLK = ppu->wire.n_PCLK == TriState::One;
+		bool H0_DD = ppu->wire.H0_Dash2 == TriState::One;
+		bool F_TB = ppu->fsm.FTB == TriState::One;
+		bool n_FO = ppu->fsm.nFO == TriState::One;
+
+		// Control
+
+		if (PCLK)
+		{
+			hle.fat_latch = ppu->fsm.FAT != TriState::One;
+			hle.tho1_latch = ppu->wire.THO[1] == TriState::One;
+		}
+
+		bool PD_SR = ppu->fsm.FTA == TriState::One && H0_DD && !PCLK;
+		bool SRLOAD = F_TB && H0_DD && !PCLK;
+		bool STEP = !PCLK && !(F_TB && H0_DD) && n_FO;
+		bool STEP2 = !PCLK && n_FO;
+		bool PD_SEL = !hle.fat_latch && !PCLK && H0_DD;
+		bool NEXT = !STEP && !STEP2 && !n_PCLK;
+
+		// Shift registers. STEP shifts SR1+SR2 as a whole (STEP implies STEP2), STEP2 alone shifts only SR2.
+
+		uint8_t PD = ppu->PD;
+
+		if (PD_SR)
+		{
+			hle.BGC0_PD = PD;
+		}
+
+		if (PD_SEL)
+		{
+			hle.PD_SEL = PD;
+		}
+
+		uint8_t sr_in[2]{};
+		uint8_t bit_in[2]{};
+
+		if (SRLOAD)
+		{
+			// The pattern bits are loaded into SR1 in the reverse order.
+
+			uint8_t n_pd = ~hle.BGC0_PD;
+			for (size_t n = 0; n < 8; n++)
+			{
+				sr_in[0] |= ((n_pd >> n) & 1) << (7 - n);
+				sr_in[1] |= ((PD >> n) & 1) << (7 - n);
+			}
+
+			size_t at_sel = (hle.tho1_latch ? 1 : 0) | (ppu->wire.TVO[1] == TriState::One ? 2 : 0);
+			bit_in[0] = (~hle.PD_SEL >> (2 * at_sel)) & 1;
+			bit_in[1] = (~hle.PD_SEL >> (2 * at_sel + 1)) & 1;
+		}
+
+		for (size_t n = 0; n < 2; n++)
+		{
+			if (STEP)
+			{
+				hle.in[n] = (hle.out[n] >> 1) | 0x8000;
+			}
+			else
+			{
+				if (STEP2)
+				{
+					hle.in[n] = (hle.in[n] & 0xff00) | ((hle.out[n] >> 1) & 0xff);
+				}
+				if (SRLOAD)
+				{
+					hle.in[n] = (hle.in[n] & 0x00ff) | (sr_in[n] << 8);
+				}
+			}
+
+			if (STEP2)
+			{
+				hle.in[2 + n] = (hle.in[2 + n] & 0xff00) | ((hle.out[2 + n] >> 1) & 0xff);
+			}
+			if (SRLOAD)
+			{
+				hle.in[2 + n] = (hle.in[2 + n] & 0x00ff) | (bit_in[n] << 8);
+			}
+		}
+
+		if (NEXT)
+		{
+			for (size_t n = 0; n < 4; n++)
+			{
+				hle.out[n] = hle.in[n];
+			}
+		}
+
+		// Output
+
+		size_t FH = (ppu->wire.FH[0] == TriState::One ? 1 : 0) |
+			(ppu->wire.FH[1] == TriState::One ? 2 : 0) |
+			(ppu->wire.FH[2] == TriState::One ? 4 : 0);
+
+		if (PCLK)
+		{
+			hle.clpb_latch = ppu->wire.n_CLPB == TriState::One;
+		}
+
+		if (n_PCLK)
+		{
+			// BGC1 goes through the shift registers in the direct logic, the others in the inverse logic.
+
+			hle.bgc_latch1 = ((~hle.out[0] >> FH) & 1) |
+				(((hle.out[1] >> FH) & 1) << 1) |
+				(((~hle.out[2] >> FH) & 1) << 2) |
+				(((~hle.out[3] >> FH) & 1) << 3);
+		}
+
+		if (PCLK)
+		{
+			hle.bgc_latch2 = ~hle.bgc_latch1 & 0xf;
+		}
+
+		uint8_t bgc = hle.clpb_latch ? (~hle.bgc_latch2 & 0xf) : 0;
+		for (size_t n = 0; n < 4; n++)
+		{
+			ppu->wire.BGC[n] = (TriState)((bgc >> n) & 1);
+		}
+	}
+
+	void BGCol::sim_Lockstep()
+	{
+		sim_HLE();
+
+		TriState hle_out[4]{};
+		for (size_t n = 0; n < 4; n++)
+		{
+			hle_out[n] = ppu->wire.BGC[n];
+		}
+
+		sim_Gates();
+
+		for (size_t n = 0; n < 4; n++)
+		{
+			if (hle_out[n] != ppu->wire.BGC[n])
+			{
+				throw "BGCol HLE does not match the gate-level model.";
+			}
+		}
+	}
+
 	void BGC_SRBit::sim(TriState shift_in, TriState val_in,
 		TriState Load, TriState Step, TriState Next,
 		TriState& shift_out)
@@ -2066,9 +2235,16 @@ namespace PPUSim
 
 	// Picture Address Register
 
-	PAR::PAR(PPU* parent)
+	PAR::PAR(PPU* parent, bool hle_mode)
 	{
 		ppu = parent;
+		HLE = hle_mode;
+
+		// Match the power-up state of the latches that store the inverted values.
+
+		hle.PD_in = 0xff;
+		hle.OV_out = 0xf;
+		hle.PAT_ADR = 0x1ff7;
 	}
 
 	PAR::~PAR()
@@ -2076,6 +2252,21 @@ namespace PPUSim
 	}
 
 	void PAR::sim()
+	{
+		if (HLE)
+		{
+#if _DEBUG
+			sim_Lockstep();
+#else
+			sim_HLE();
+#endif
+			return;
+		}
+
+		sim_Gates();
+	}
+
+	void PAR::sim_Gates()
 	{
 		sim_Control();
 		sim_VInv();
@@ -2161,6 +2352,106 @@ namespace PPUSim
 		}
 	}
 
+	void PAR::sim_HLE()
+	{
+		bool n_PCLK = ppu->wire.n_PCLK == TriState::One;
+		bool OBJ_READ = ppu->fsm.OBJ_READ == TriState::One;
+		bool O8_16 = ppu->wire.O8_16 == TriState::One;
+
+		// Control
+
+		if (n_PCLK)
+		{
+			hle.fnt_latch = ppu->wire.H0_Dash2 != TriState::One || ppu->fsm.nFNT == TriState::One;
+		}
+		bool O = !hle.fnt_latch && !n_PCLK;
+
+		if (O)
+		{
+			uint8_t ob = 0;
+			for (size_t n = 0; n < 8; n++)
+			{
+				ob |= (ppu->wire.OB[n] == TriState::One ? 1 : 0) << n;
+			}
+			hle.OB = ob;
+		}
+
+		// VInv
+
+		if (!n_PCLK && ppu->wire.n_OBJ_RD_ATTR == TriState::Zero)
+		{
+			hle.VINV_FF = ppu->wire.OB[7] == TriState::One;
+		}
+
+		// Inverted bits (sprite row) and PD bits (tile index)
+
+		if (n_PCLK)
+		{
+			uint8_t ov = 0;
+			for (size_t n = 0; n < 4; n++)
+			{
+				ov |= (ppu->wire.OV[n] == TriState::One ? 1 : 0) << n;
+			}
+			hle.OV_in = ov;
+			hle.PD_in = ppu->PD;
+		}
+
+		if (O)
+		{
+			hle.OV_out = hle.OV_in;
+			hle.PD_out = hle.PD_in;
+		}
+
+		uint8_t inv_out = hle.VINV_FF ? hle.OV_out : (~hle.OV_out & 0xf);
+
+		// Pattern address latches
+
+		if (n_PCLK)
+		{
+			uint16_t pat = 0;
+
+			if (OBJ_READ)
+			{
+				pat |= ~inv_out & 7;
+				pat |= (O8_16 ? ((~inv_out >> 3) & 1) : (hle.OB & 1)) << 4;
+				pat |= (uint16_t)(hle.OB >> 1) << 5;
+				pat |= (O8_16 ? (hle.OB & 1) : (ppu->wire.OBSEL == TriState::One ? 0 : 1)) << 12;
+			}
+			else
+			{
+				for (size_t n = 0; n < 3; n++)
+				{
+					pat |= (ppu->wire.FVO[n] == TriState::One ? 1 : 0) << n;
+				}
+				pat |= (uint16_t)hle.PD_out << 4;
+				pat |= (ppu->wire.BGSEL == TriState::One ? 0 : 1) << 12;
+			}
+
+			hle.PAT_ADR = pat;
+		}
+
+		hle.PAT_ADR = (hle.PAT_ADR & ~0x2008) | (ppu->wire.nH1_Dash == TriState::One ? 0 : 0x0008);
+	}
+
+	void PAR::sim_Lockstep()
+	{
+		sim_HLE();
+		sim_Gates();
+
+		for (size_t n = 0; n < 14; n++)
+		{
+			if ((TriState)((hle.PAT_ADR >> n) & 1) != ppu->wire.PAT_ADR[n])
+			{
+				throw "PAR HLE does not match the gate-level model.";
+			}
+		}
+	}
+
+	uint16_t PAR::get_PAT_ADR()
+	{
+		return hle.PAT_ADR;
+	}
+
 	void ParBitInv::sim(TriState n_PCLK, TriState O, TriState INV, TriState val_in,
 		TriState& val_out)
 	{
@@ -2366,9 +2657,10 @@ namespace PPUSim
 
 	// PPU Address Mux
 
-	PAMUX::PAMUX(PPU* parent)
+	PAMUX::PAMUX(PPU* parent, bool hle_mode)
 	{
 		ppu = parent;
+		HLE = hle_mode;
 	}
 
 	PAMUX::~PAMUX()
@@ -2377,6 +2669,14 @@ namespace PPUSim
 
 	void PAMUX::sim()
 	{
+		if (HLE)
+		{
+			sim_ControlHLE();
+#if !_DEBUG
+			return;
+#endif
+		}
+
 		sim_Control();
 	}
 
@@ -2394,6 +2694,14 @@ namespace PPUSim
 
 	void PAMUX::sim_MuxInputs()
 	{
+		if (HLE)
+		{
+			sim_MuxInputsHLE();
+#if !_DEBUG
+			return;
+#endif
+		}
+
 		TriState BLNK = ppu->fsm.BLNK;
 
 		AT_ADR[0] = ppu->wire.THO[2];
@@ -2431,6 +2739,14 @@ namespace PPUSim
 
 	void PAMUX::sim_MuxOutputs()
 	{
+		if (HLE)
+		{
+			sim_MuxOutputsHLE();
+#if !_DEBUG
+			return;
+#endif
+		}
+
 		TriState PCLK = ppu->wire.PCLK;
 		TriState DB_PAR = ppu->wire.DB_PAR;
 		TriState F_AT = ppu->fsm.FAT;
@@ -2444,6 +2760,106 @@ namespace PPUSim
 		{
 			par_hi[n].sim(PCLK, PARR, PAH, F_AT, AT_ADR[8 + n], NT_ADR[8 + n], PAT_ADR[8 + n], ppu->wire.n_PA_Top[n]);
 		}
+
+#if _DEBUG
+		// Lockstep: the gate-level model has just overwritten the /PA outputs, they must be the same.
+
+		if (HLE)
+		{
+			for (size_t n = 0; n < 14; n++)
+			{
+				TriState n_PA = n < 8 ? ppu->wire.n_PA_Bot[n] : ppu->wire.n_PA_Top[n - 8];
+				if (n_PA != (TriState)((~ppu->PA >> n) & 1))
+				{
+					throw "PAMUX HLE does not match the gate-level model.";
+				}
+			}
+		}
+#endif
+	}
+
+	void PAMUX::sim_ControlHLE()
+	{
+		hle.PARR = !(ppu->wire.nH2_Dash == TriState::One || ppu->fsm.BLNK == TriState::One);
+		hle.PAH = !(hle.PARR || ppu->fsm.FAT == TriState::One);
+		hle.PAL = hle.PAH && ppu->wire.DB_PAR != TriState::One;
+	}
+
+	void PAMUX::sim_MuxInputsHLE()
+	{
+		uint16_t TH = 0;
+		uint16_t TV = 0;
+
+		for (size_t n = 0; n < 5; n++)
+		{
+			TH |= (ppu->wire.THO[n] == TriState::One ? 1 : 0) << n;
+			TV |= (ppu->wire.TVO[n] == TriState::One ? 1 : 0) << n;
+		}
+
+		bool BLNK = ppu->fsm.BLNK == TriState::One;
+		uint16_t common = (ppu->wire.NTHOut == TriState::One ? 0x400 : 0) |
+			(ppu->wire.NTVOut == TriState::One ? 0x800 : 0) |
+			(BLNK && ppu->wire.n_FVO[0] == TriState::Zero ? 0x1000 : 0) |
+			(!BLNK || ppu->wire.FVO[1] == TriState::One ? 0x2000 : 0);
+
+		hle.AT_ADR = common | 0x3c0 | (TV & 0x1c) << 1 | (TH >> 2);
+		hle.NT_ADR = common | (TV << 5) | TH;
+		hle.PAT_ADR = ppu->data_reader->par->get_PAT_ADR();
+	}
+
+	void PAMUX::sim_MuxOutputsHLE()
+	{
+		bool F_AT = ppu->fsm.FAT == TriState::One;
+		uint16_t in = hle.in;
+
+		// The low and high halves of the mux are controlled differently (DB_PAR and PAL only affect the low half).
+
+		if (ppu->wire.DB_PAR == TriState::One)
+		{
+			in = (in & 0x3f00) | ppu->DB;
+		}
+		else if (hle.PARR)
+		{
+			in = (in & 0x3f00) | (hle.PAT_ADR & 0xff);
+		}
+		else if (hle.PAL)
+		{
+			in = (in & 0x3f00) | (hle.NT_ADR & 0xff);
+		}
+		else if (F_AT)
+		{
+			in = (in & 0x3f00) | (hle.AT_ADR & 0xff);
+		}
+
+		if (hle.PARR)
+		{
+			in = (in & 0xff) | (hle.PAT_ADR & 0x3f00);
+		}
+		else if (hle.PAH)
+		{
+			in = (in & 0xff) | (hle.NT_ADR & 0x3f00);
+		}
+		else if (F_AT)
+		{
+			in = (in & 0xff) | (hle.AT_ADR & 0x3f00);
+		}
+
+		hle.in = in;
+
+		if (ppu->wire.PCLK == TriState::One)
+		{
+			ppu->PA = in;
+
+			for (size_t n = 0; n < 8; n++)
+			{
+				ppu->wire.n_PA_Bot[n] = (TriState)((~in >> n) & 1);
+			}
+
+			for (size_t n = 0; n < 6; n++)
+			{
+				ppu->wire.n_PA_Top[n] = (TriState)((~in >> (8 + n)) & 1);
+			}
+		}
 	}
 
 	void PAMUX_LowBit::sim(TriState PCLK, TriState PARR, TriState DB_PAR, TriState PAL, TriState F_AT,
@@ -2864,11 +3280,11 @@ namespace PPUSim
 	{
 		ppu = parent;
 
-		par = new PAR(ppu);
+		par = new PAR(ppu, ppu->HLE_Mode);
 		tilecnt = new TileCnt(ppu);
-		pamux = new PAMUX(ppu);
+		pamux = new PAMUX(ppu, ppu->HLE_Mode);
 		sccx = new ScrollRegs(ppu);
-		bgcol = new BGCol(ppu);
+		bgcol = new BGCol(ppu, ppu->HLE_Mode);
 	}
 
 	DataReader::~DataReader()
@@ -2893,9 +3309,10 @@ namespace PPUSim
 
 	// Sprite Comparison
 
-	ObjEval::ObjEval(PPU* parent)
+	ObjEval::ObjEval(PPU* parent, bool hle_mode)
 	{
 		ppu = parent;
+		HLE = hle_mode;
 	}
 
 	ObjEval::~ObjEval()
@@ -2903,6 +3320,21 @@ namespace PPUSim
 	}
 
 	void ObjEval::sim()
+	{
+		if (HLE)
+		{
+#if _DEBUG
+			sim_Lockstep();
+#else
+			sim_HLE();
+#endif
+			return;
+		}
+
+		sim_Gates();
+	}
+
+	void ObjEval::sim_Gates()
 	{
 		sim_StepJohnson();
 		sim_Comparator();
@@ -3310,8 +3742,435 @@ namespace PPUSim
 		return SPR_OV_FF.get();
 	}
 
+	void ObjEval::sim_HLE()
+	{
+		bool PCLK = ppu->wire.PCLK == TriState::One;
+		bool n_PCLK = ppu->wire.n_PCLK == TriState::One;
+		bool H0_D = ppu->wire.H0_Dash == TriState::One;
+		bool H0_DD = ppu->wire.H0_Dash2 == TriState::One;
+		bool n_H2_D = ppu->wire.nH2_Dash == TriState::One;
+		bool I_OAM2 = ppu->fsm.IOAM2 == TriState::One;
+		bool n_VIS = ppu->fsm.nVIS == TriState::One;
+		bool BLNK = ppu->fsm.BLNK == TriState::One;
+		bool OBJ_READ = ppu->fsm.OBJ_READ == TriState::One;
+		bool n_EVAL = ppu->fsm.n_EVAL == TriState::One;
+		bool n_DBE = ppu->wire.n_DBE == TriState::One;
+		bool PAL = ppu->rev == Revision::RP2C07_0 || ppu->rev == Revision::UMC_UA6538;
+
+		// Johnson counter (backwards, as in the gate-level model)
+
+		bool COPY_STEP = !PCLK && H0_DD;
+		uint8_t i2 = hle.i2;
+		if (PCLK) i2 = (i2 & ~0x20) | ((~i2 << 1) & 0x20);
+		if (COPY_STEP) i2 = (i2 & ~0x10) | ((~i2 << 1) & 0x10);
+		if (PCLK) i2 = (i2 & ~0x08) | ((~i2 << 1) & 0x08);
+		if (COPY_STEP) i2 = (i2 & ~0x04) | ((~i2 << 1) & 0x04);
+		if (PCLK) i2 = (i2 & ~0x02) | ((~i2 << 1) & 0x02);
+		bool COPY_OVF = (i2 & 0x2a) != 0x2a;
+
+		// Comparator. The chain of OAMCmprBit is just a V - OB subtractor.
+
+		if (PCLK)
+		{
+			uint8_t ob = 0;
+			for (size_t n = 0; n < 8; n++)
+			{
+				ob |= (ppu->oam->get_OB(n) == TriState::One ? 1 : 0) << n;
+			}
+			hle.OB = ob;
+		}
+
+		uint8_t V = (uint8_t)ppu->v->get();
+		uint8_t OV = V - hle.OB;
+		for (size_t n = 0; n < 8; n++)
+		{
+			ppu->wire.OV[n] = (TriState)((OV >> n) & 1);
+		}
+
+		bool O8_16 = ppu->wire.O8_16 == TriState::One;
+		hle.OVZ = !((OV & 0xf0) || ((OV & 0x08) && !O8_16) || ((hle.OB & 0x80) && !(V & 0x80)) || COPY_OVF);
+
+		// Comparison FSM
+
+		if (!PCLK)
+		{
+			hle.fnt_latch = ppu->fsm.nFNT == TriState::One || !H0_DD;
+			hle.novz_latch = !hle.OVZ;
+		}
+		if (PCLK && !hle.fnt_latch)
+		{
+			hle.eval_FF3 = !hle.novz_latch;
+		}
+		ppu->wire.PD_FIFO = hle.eval_FF3 ? TriState::One : TriState::Zero;
+
+		bool DO_COPY = !(I_OAM2 || n_VIS || hle.SPR_OV_FF || !hle.OVZ);
+		if (COPY_STEP) i2 = (i2 & ~0x01) | (DO_COPY ? 0x01 : 0);
+		hle.i2 = i2;
+		hle.OMFG = !(COPY_OVF || DO_COPY);
+
+		if (!PCLK && ppu->fsm.SEV == TriState::One)
+		{
+			hle.eval_FF2 = DO_COPY;
+		}
+		if (!PCLK && OBJ_READ)
+		{
+			hle.eval_FF1 = !hle.eval_FF2;
+		}
+		ppu->wire.n_SPR0_EV = hle.eval_FF1 ? TriState::One : TriState::Zero;
+
+		// Main Counter Control
+
+		bool ZOMG = false;
+
+		if (PAL)
+		{
+			bool W3 = !(ppu->wire.n_W3 == TriState::One || n_DBE);
+			hle.W3_FF1 = (W3 || hle.W3_FF1) && hle.w3_latch3;
+			bool w3_ff1_out = hle.W3_FF1 && !W3;
+			if (PCLK) hle.W3_FF2 = w3_ff1_out;
+			if (n_PCLK) hle.w3_latch1 = !hle.W3_FF2;
+			if (PCLK) hle.w3_latch2 = !hle.w3_latch1;
+			if (n_PCLK) hle.w3_latch3 = !hle.w3_latch2;
+			if (PCLK) hle.w3_latch4 = !hle.w3_latch3;
+			hle.W3_Enable = !hle.w3_latch4 && hle.w3_latch2;
+			ZOMG = ppu->wire.EvenOddOut == TriState::One;
+		}
+		else
+		{
+			hle.W3_Enable = !(ppu->wire.n_W3 == TriState::One || n_DBE);
+		}
+
+		if (n_PCLK)
+		{
+			hle.init_latch = !(!(I_OAM2 || n_VIS) && H0_DD);
+			hle.ofetch_latch = ppu->wire.OFETCH == TriState::One;
+		}
+		hle.OMSTEP = !((hle.init_latch || n_PCLK) && !((hle.ofetch_latch && !n_PCLK) || ZOMG));
+		bool OMOUT = !(hle.OMSTEP || hle.W3_Enable);
+
+		// Main Counter (OAMCounterBit x8). In Mode4 the lower 2 bits are blocked and the counter counts by 4.
+
+		bool Mode4 = !BLNK && hle.OMFG;
+		uint8_t keep = hle.MainKeep;
+
+		if (hle.OMSTEP)
+		{
+			keep = ~hle.MainCnt & (Mode4 ? 0xfc : 0xff);
+		}
+		else if (hle.W3_Enable)
+		{
+			keep = ppu->DB;
+		}
+		else if (OMOUT && OBJ_READ)
+		{
+			keep = 0;
+		}
+
+		uint8_t carry = 0x01 | ((keep & 0x01) << 1);
+		if (Mode4 || (keep & 0x03) == 0x03)
+		{
+			carry |= 0x04;
+			for (size_t n = 2; n < 7 && (keep & (1 << n)); n++)
+			{
+				carry |= 1 << (n + 1);
+			}
+		}
+		bool OMV = (carry & keep & 0x80) != 0;
+
+		if (OMOUT)
+		{
+			hle.MainCnt = ~(keep ^ carry) & (OBJ_READ ? ~carry : 0xff);
+		}
+		hle.MainKeep = keep;
+
+		if (n_PCLK)
+		{
+			hle.omv_latch = OMV;
+		}
+
+		// Temp Counter Control
+
+		if (n_PCLK)
+		{
+			hle.eval_latch = n_EVAL;
+			hle.nomfg_latch = !hle.OMFG;
+			hle.ioam2_latch = I_OAM2;
+			hle.temp_latch1 = !(!hle.OAMCTR2_FF && n_EVAL);
+		}
+		bool ORES = !(n_PCLK || hle.eval_latch);
+		bool DontStep = !(!(!(hle.nomfg_latch || hle.ioam2_latch) || H0_D) || (n_H2_D && OBJ_READ));
+		bool OSTEP = !(hle.temp_latch1 || n_PCLK || DontStep);
+
+		// Temp Counter (OAMCounterBit x5)
+
+		keep = hle.TempKeep;
+
+		if (OSTEP)
+		{
+			keep = ~hle.TempCnt & 0x1f;
+		}
+		else if (ORES)
+		{
+			keep = 0;
+		}
+
+		carry = 0x01;
+		for (size_t n = 0; n < 5 && (keep & (1 << n)); n++)
+		{
+			carry |= 1 << (n + 1);
+		}
+		bool TMV = (carry & 0x20) != 0;
+
+		if (n_PCLK)
+		{
+			hle.TempCnt = ~(keep ^ carry) & 0x1f;
+		}
+		hle.TempKeep = keep;
+
+		if (n_PCLK)
+		{
+			hle.tmv_latch = TMV;
+		}
+		hle.OAMCTR2_FF = !ORES && ((hle.tmv_latch && OSTEP) || hle.OAMCTR2_FF);
+		ppu->wire.OAMCTR2 = hle.OAMCTR2_FF ? TriState::One : TriState::Zero;
+
+		// Sprite Overflow
+
+		if (n_PCLK)
+		{
+			hle.omfg_latch = hle.OMFG;
+			hle.setov_latch = !hle.OAMCTR2_FF;
+		}
+		bool TempOVF = !(hle.omfg_latch || hle.setov_latch || H0_D || n_PCLK);
+		bool MainOVF = hle.OMSTEP && hle.omv_latch;
+		bool RESCL = ppu->fsm.RESCL == TriState::One;
+		hle.SPR_OV_REG_FF = (TempOVF || hle.SPR_OV_REG_FF) && !RESCL;
+		hle.SPR_OV_FF = (MainOVF || TempOVF || hle.SPR_OV_FF) && !I_OAM2;
+		ppu->wire.SPR_OV = hle.SPR_OV_FF ? TriState::One : TriState::Zero;
+
+		if (ppu->wire.n_R2 == TriState::Zero && !n_DBE)
+		{
+			ppu->SetDBBit(5, hle.SPR_OV_REG_FF ? TriState::One : TriState::Zero);
+		}
+
+		// OAM Address
+
+		bool OAP;
+		if (PAL)
+		{
+			if (n_PCLK) hle.blnk_latch = BLNK;
+			OAP = !((n_VIS || H0_DD) && !hle.blnk_latch);
+		}
+		else
+		{
+			OAP = !((n_VIS || H0_DD) && !BLNK);
+		}
+
+		ppu->wire.OAM8 = OAP ? TriState::Zero : TriState::One;
+
+		uint8_t oam_addr = OAP ? hle.MainKeep : ((hle.MainKeep & 0x07) | (hle.TempKeep << 3));
+		for (size_t n = 0; n < 8; n++)
+		{
+			ppu->wire.n_OAM[n] = (oam_addr >> n) & 1 ? TriState::Zero : TriState::One;
+		}
+	}
+
+	void ObjEval::sim_Lockstep()
+	{
+		uint8_t DB = ppu->DB;
+
+		sim_HLE();
+
+		TriState hle_out[20]{};
+		for (size_t n = 0; n < 8; n++)
+		{
+			hle_out[n] = ppu->wire.n_OAM[n];
+			hle_out[8 + n] = ppu->wire.OV[n];
+		}
+		hle_out[16] = ppu->wire.OAM8;
+		hle_out[17] = ppu->wire.PD_FIFO;
+		hle_out[18] = ppu->wire.n_SPR0_EV;
+		hle_out[19] = ppu->wire.SPR_OV;
+		TriState hle_OAMCTR2 = ppu->wire.OAMCTR2;
+		uint8_t hle_DB = ppu->DB;
+
+		ppu->DB = DB;
+
+		sim_Gates();
+
+		bool match = hle_OAMCTR2 == ppu->wire.OAMCTR2 && hle_DB == ppu->DB;
+		for (size_t n = 0; n < 8; n++)
+		{
+			match &= hle_out[n] == ppu->wire.n_OAM[n];
+			match &= hle_out[8 + n] == ppu->wire.OV[n];
+		}
+		match &= hle_out[16] == ppu->wire.OAM8;
+		match &= hle_out[17] == ppu->wire.PD_FIFO;
+		match &= hle_out[18] == ppu->wire.n_SPR0_EV;
+		match &= hle_out[19] == ppu->wire.SPR_OV;
+
+		if (!match)
+		{
+			throw "ObjEval HLE does not match the gate-level model.";
+		}
+	}
+
 	// Video Signal Generator
 
+	// The PLA matrices of the PAL chroma decoder and of the RGB PPU color matrix are unfolded at compile time into lookup tables.
+	// Each lane holds the outputs of the matrix for one combination of the decoder inputs, so no PLA dump on disk is needed.
+
+	/// <summary>
+	/// Simulate a single PLA term the same way as BaseLogic::PLA does it (msb of the bitmask corresponds to input `0`).
+	/// </summary>
+	static constexpr bool PLATerm(size_t bitmask, size_t inputs, size_t input_bits)
+	{
+		for (size_t bit = 0; bit < inputs; bit++)
+		{
+			if (((bitmask >> (inputs - bit - 1)) & 1) && ((input_bits >> bit) & 1))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static constexpr size_t PALChromaDecoderMatrix[] = {
+		0b1001100110,
+		0b0110100101,
+		0b1010100101,
+		0b0101100110,
+		0b1001010110,
+		0b0110011001,
+		0b1010011010,
+		0b0101011010,
+		0b1001101001,
+		0b0110101001,
+		0b0010101010,
+		0b1010100110,
+		0b0101101010,
+		0b1001011001,
+		0b0110010110,
+		0b1010010110,
+		0b0101011001,
+		0b1001101010,
+		0b0110100110,
+		0b1010101001,
+		0b0101101001,
+		0b1001011010,
+		0b0110011010,
+		0b1010011001,
+		0b0101010110,
+	};
+
+	struct PALChromaDecoderTable
+	{
+		uint32_t lane[32];		// Index: V0, CC0, CC1, CC2, CC3 (packed bits). Value: 25 decoder outputs (packed bits).
+	};
+
+	static constexpr PALChromaDecoderTable MakePALChromaDecoderTable()
+	{
+		PALChromaDecoderTable t{};
+
+		for (size_t n = 0; n < 32; n++)
+		{
+			// Each decoder input comes in pairs: /V0, V0, /CC0, CC0, ... /CC3, CC3
+
+			size_t input_bits = 0;
+			for (size_t bit = 0; bit < 5; bit++)
+			{
+				size_t val = (n >> bit) & 1;
+				input_bits |= ((val ^ 1) << (2 * bit)) | (val << (2 * bit + 1));
+			}
+
+			for (size_t out = 0; out < 25; out++)
+			{
+				if (PLATerm(PALChromaDecoderMatrix[out], 10, input_bits))
+				{
+					t.lane[n] |= 1 << out;
+				}
+			}
+		}
+
+		return t;
+	}
+
+	static constexpr PALChromaDecoderTable PALChromaDecoderLanes = MakePALChromaDecoderTable();
+
+	/// <summary>
+	/// Chroma decoder outputs gated by the phase shifter bits PZ[n].
+	/// </summary>
+	static constexpr uint32_t PALPhaseOutputs[13] = {
+		0b11 << 0, 0b11 << 2, 0b11 << 4, 0b11 << 6, 0,
+		0b11 << 8, 0b11 << 11, 0b11 << 13, 0b11 << 15,
+		0b11 << 17, 0b11 << 19, 0b11 << 21, 0b11 << 23,
+	};
+
+	static constexpr size_t RP2C04_0003_ColorMatrix[] = {
+		0b1010100001110110,
+		0b1111000101010100,
+		0b0000110101000000,
+		0b0101111001100110,
+		0b1000000001111011,
+		0b0110110110110100,
+		0b0001100101010011,
+		0b1111101000110111,
+		0b1010000001111000,
+		0b1111110100111100,
+		0b0110100101101001,
+		0b1111100100010110,
+
+		0b1010110001010110,
+		0b0101010111100101,
+		0b0000100101110000,
+		0b1110101111001101,
+		0b0001110011100001,
+		0b0101111010010100,
+		0b0100111111011000,
+		0b1000001010111111,
+		0b1010010001011110,
+		0b0101110101011100,
+		0b1010101111010110,
+		0b1010010010111011,
+
+		0b1110100100100110,
+		0b0111011110100100,
+		0b1011101101111001,
+		0b0110011011100010,
+		0b0000100110000111,
+		0b0111101110110100,
+		0b1010101001100100,
+		0b0110011010101110,
+		0b1010100101000110,
+		0b1111101111111100,
+		0b1011101001100100,
+		0b0010110010101110,
+	};
+
+	struct ColorMatrixTable
+	{
+		TriState lane[17][12 * 3];	// Index: CC2, CC3, /LL0, /LL1 (packed bits); lane 16 is used when PCLK = 0 (no matrix input is active).
+	};
+
+	static constexpr ColorMatrixTable MakeColorMatrixTable(const size_t(&bitmask)[12 * 3])
+	{
+		ColorMatrixTable t{};
+
+		for (size_t n = 0; n < 17; n++)
+		{
+			size_t input_bits = n < 16 ? (1ULL << n) : 0;
+
+			for (size_t out = 0; out < 12 * 3; out++)
+			{
+				t.lane[n][out] = PLATerm(bitmask[out], 16, input_bits) ? TriState::One : TriState::Zero;
+			}
+		}
+
+		return t;
+	}
+
+	static constexpr ColorMatrixTable RP2C04_0003_ColorMatrixLanes = MakeColorMatrixTable(RP2C04_0003_ColorMatrix);
+
 	VideoOut::VideoOut(PPU* parent)
 	{
 		ppu = parent;
@@ -3401,7 +4260,7 @@ namespace PPUSim
 			// TBD: others (RGB, clones)
 		}
 
-		// For PAL-like composite PPUs, the Chroma decoder simulation is done using PLA, since the decoder there is big enough (so you don't have to bother with it).
+		// For PAL-like composite PPUs, the Chroma decoder simulation is done using a PLA matrix unfolded into a lookup table, since the decoder there is big enough (so you don't have to bother with it).
 
 		switch (ppu->rev)
 		{
@@ -3414,15 +4273,6 @@ namespace PPUSim
 
 	VideoOut::~VideoOut()
 	{
-		if (chroma_decoder != nullptr)
-		{
-			delete chroma_decoder;
-		}
-
-		if (color_matrix != nullptr)
-		{
-			delete color_matrix;
-		}
 	}
 
 	void VideoOut::sim(VideoOutSignal& vout)
@@ -3569,59 +4419,34 @@ namespace PPUSim
 
 	void VideoOut::sim_ChromaDecoder_PAL()
 	{
-		PALChromaInputs chroma_in{};
-
-		chroma_in.n_V0 = v0_latch.nget();
-		chroma_in.V0 = ~chroma_in.n_V0;
-		chroma_in.CC0 = cc_latch2[0].nget();
-		chroma_in.n_CC0 = ~chroma_in.CC0;
-		chroma_in.CC1 = NOR(cc_latch2[1].get(), cc_burst_latch.get());
-		chroma_in.n_CC1 = ~chroma_in.CC1;
-		chroma_in.CC2 = cc_latch2[2].nget();
-		chroma_in.n_CC2 = ~chroma_in.CC2;
-		chroma_in.CC3 = NOR(cc_latch2[3].get(), cc_burst_latch.get());
-		chroma_in.n_CC3 = ~chroma_in.CC3;
-
-		PBLACK = NOR3(NOR(cc_latch2[1].get(), cc_burst_latch.get()), cc_latch2[2].nget(), NOR(cc_latch2[3].get(), cc_burst_latch.get()));
-
-		TriState* chroma_out;
-
-		chroma_decoder->sim(chroma_in.packed_bits, &chroma_out);
-
-		TriState pz[25]{};
+		TriState n_V0 = v0_latch.nget();
+		TriState CC0 = cc_latch2[0].nget();
+		TriState CC1 = NOR(cc_latch2[1].get(), cc_burst_latch.get());
+		TriState CC2 = cc_latch2[2].nget();
+		TriState CC3 = NOR(cc_latch2[3].get(), cc_burst_latch.get());
 
-		pz[0] = AND(chroma_out[0], NOT(PZ[0]));
-		pz[1] = AND(chroma_out[1], NOT(PZ[0]));
-		pz[2] = AND(chroma_out[2], NOT(PZ[1]));
-		pz[3] = AND(chroma_out[3], NOT(PZ[1]));
+		PBLACK = NOR3(CC1, CC2, CC3);
 
-		pz[4] = AND(chroma_out[4], NOT(PZ[2]));
-		pz[5] = AND(chroma_out[5], NOT(PZ[2]));
-		pz[6] = AND(chroma_out[6], NOT(PZ[3]));
-		pz[7] = AND(chroma_out[7], NOT(PZ[3]));
+		size_t lane =
+			(n_V0 == TriState::One ? 0 : 1) |
+			(CC0 == TriState::One ? 0b10 : 0) |
+			(CC1 == TriState::One ? 0b100 : 0) |
+			(CC2 == TriState::One ? 0b1000 : 0) |
+			(CC3 == TriState::One ? 0b10000 : 0);
 
-		pz[8] = AND(chroma_out[8], NOT(PZ[5]));
-		pz[9] = AND(chroma_out[9], NOT(PZ[5]));
-		pz[10] = chroma_out[10];
-		pz[11] = AND(chroma_out[11], NOT(PZ[6]));
+		// Each pair of the decoder outputs is gated by the phase shifter bit of the same phase (output 10 is not gated).
 
-		pz[12] = AND(chroma_out[12], NOT(PZ[6]));
-		pz[13] = AND(chroma_out[13], NOT(PZ[7]));
-		pz[14] = AND(chroma_out[14], NOT(PZ[7]));
-		pz[15] = AND(chroma_out[15], NOT(PZ[8]));
+		uint32_t phase_mask = 1 << 10;
 
-		pz[16] = AND(chroma_out[16], NOT(PZ[8]));
-		pz[17] = AND(chroma_out[17], NOT(PZ[9]));
-		pz[18] = AND(chroma_out[18], NOT(PZ[9]));
-		pz[19] = AND(chroma_out[19], NOT(PZ[10]));
-
-		pz[20] = AND(chroma_out[20], NOT(PZ[10]));
-		pz[21] = AND(chroma_out[21], NOT(PZ[11]));
-		pz[22] = AND(chroma_out[22], NOT(PZ[11]));
-		pz[23] = AND(chroma_out[23], NOT(PZ[12]));
-		pz[24] = AND(chroma_out[24], NOT(PZ[12]));
+		for (size_t n = 0; n < 13; n++)
+		{
+			if (PZ[n] == TriState::Zero)
+			{
+				phase_mask |= PALPhaseOutputs[n];
+			}
+		}
 
-		n_PZ = NOR25(pz);
+		n_PZ = (chroma_decoder[lane] & phase_mask) != 0 ? TriState::Zero : TriState::One;
 	}
 
 	void VideoOut::sim_ChromaDecoder_NTSC()
@@ -4046,132 +4871,37 @@ namespace PPUSim
 
 	void VideoOut::SetupChromaDecoderPAL()
 	{
-		chroma_decoder = new PLA(chroma_decoder_inputs, chroma_decoder_outputs, (char*)"PALChromaDecoder.bin");
-
-		// Set matrix
-
-		static size_t bitmask[] = {
-			0b1001100110,
-			0b0110100101,
-			0b1010100101,
-			0b0101100110,
-			0b1001010110,
-			0b0110011001,
-			0b1010011010,
-			0b0101011010,
-			0b1001101001,
-			0b0110101001,
-			0b0010101010,
-			0b1010100110,
-			0b0101101010,
-			0b1001011001,
-			0b0110010110,
-			0b1010010110,
-			0b0101011001,
-			0b1001101010,
-			0b0110100110,
-			0b1010101001,
-			0b0101101001,
-			0b1001011010,
-			0b0110011010,
-			0b1010011001,
-			0b0101010110,
-		};
-
-		chroma_decoder->SetMatrix(bitmask);
+		chroma_decoder = PALChromaDecoderLanes.lane;
 	}
 
 #pragma region "RGB PPU Stuff"
 
 	void VideoOut::SetupColorMatrix()
 	{
-		char colorMatrixName[0x20] = { 0 };
-
-		// Generate PLA dump name according to the PPU revision.
-
-		sprintf(colorMatrixName, "ColorMatrix_%s.bin", ppu->RevisionToStr(ppu->rev));
-
-		color_matrix = new PLA(color_matrix_inputs, color_matrix_outputs, colorMatrixName);
-
-		// Set matrix
-
-		size_t* bitmask = nullptr;
-
 		switch (ppu->rev)
 		{
 		case Revision::RP2C04_0003:
-		{
-			static size_t RP2C04_0003_ColorMatrix[] = {		// Undefined behavior in GCC if you do not specify static
-				0b1010100001110110,
-				0b1111000101010100,
-				0b0000110101000000,
-				0b0101111001100110,
-				0b1000000001111011,
-				0b0110110110110100,
-				0b0001100101010011,
-				0b1111101000110111,
-				0b1010000001111000,
-				0b1111110100111100,
-				0b0110100101101001,
-				0b1111100100010110,
-
-				0b1010110001010110,
-				0b0101010111100101,
-				0b0000100101110000,
-				0b1110101111001101,
-				0b0001110011100001,
-				0b0101111010010100,
-				0b0100111111011000,
-				0b1000001010111111,
-				0b1010010001011110,
-				0b0101110101011100,
-				0b1010101111010110,
-				0b1010010010111011,
-
-				0b1110100100100110,
-				0b0111011110100100,
-				0b1011101101111001,
-				0b0110011011100010,
-				0b0000100110000111,
-				0b0111101110110100,
-				0b1010101001100100,
-				0b0110011010101110,
-				0b1010100101000110,
-				0b1111101111111100,
-				0b1011101001100100,
-				0b0010110010101110,
-			};
-
-			bitmask = RP2C04_0003_ColorMatrix;
-		}
-		break;
-		}
-
-		if (bitmask != nullptr)
-		{
-			color_matrix->SetMatrix(bitmask);
+			color_matrix = &RP2C04_0003_ColorMatrixLanes.lane[0][0];
+			break;
 		}
 	}
 
 	void VideoOut::sim_ColorMatrix()
 	{
 		TriState PCLK = ppu->wire.PCLK;
-		TriState col[4]{};
-		size_t packed = 0;
+		size_t lane = 16;
 
 		if (PCLK == TriState::One)
 		{
-			TriState unpacked[16]{};
+			TriState col[4]{};
 			col[0] = cc_latch2[2].nget();
 			col[1] = cc_latch2[3].nget();
 			col[2] = ppu->wire.n_LL[0];
 			col[3] = ppu->wire.n_LL[1];
-
-			DMX4(col, unpacked);
-			packed = Pack(unpacked) | ((size_t)Pack(&unpacked[8]) << 8);
+			lane = PackNibble(col);
 		}
 
-		color_matrix->sim(packed, &rgb_output);
+		rgb_output = &color_matrix[lane * 12 * 3];
 	}
 
 	void VideoOut::sim_Select12To3()
@@ -4222,7 +4952,7 @@ namespace PPUSim
 		vout.RGB.nSYNC = rgb_sync_latch[2].nget();
 	}
 
-	void RGB_SEL12x3::sim(TriState PCLK, TriState n_Tx, TriState col_in[12], TriState lum_in[2])
+	void RGB_SEL12x3::sim(TriState PCLK, TriState n_Tx, const TriState col_in[12], TriState lum_in[2])
 	{
 		TriState mux_in[4]{};
 		TriState mux_out{};
@@ -4298,6 +5028,11 @@ namespace PPUSim
 		return composite;
 	}
 
+	bool VideoOut::IsRAWOutput()
+	{
+		return raw;
+	}
+
 	float VideoOut::GetNoise()
 	{
 		float a = -noise;
@@ -4526,9 +5261,11 @@ namespace PPUSim
 	/// </summary>
 	/// <param name="_rev">Revision of the PPU chip.</param>
 	/// <param name="VideoGen">true: Create a special version of the PPU that contains only a video generator.</param>
-	PPU::PPU(Revision _rev, bool VideoGen)
+	/// <param name="HLE">true: Use the accelerated (integer) versions of some circuits. The result is the same.</param>
+	PPU::PPU(Revision _rev, bool VideoGen, bool HLE)
 	{
 		rev = _rev;
+		HLE_Mode = HLE;
 
 		if (!VideoGen)
 		{
@@ -4539,7 +5276,7 @@ namespace PPUSim
 			hv_fsm = new FSM(this);
 			cram = new CRAM(this);
 			mux = new Mux(this);
-			eval = new ObjEval(this);
+			eval = new ObjEval(this, HLE_Mode);
 			oam = new OAM(this);
 			fifo = new FIFO(this);
 			data_reader = new DataReader(this);
@@ -4589,8 +5326,6 @@ namespace PPUSim
 		wire.RS[2] = inputs[(size_t)InputPad::RS2];
 		wire.n_DBE = inputs[(size_t)InputPad::n_DBE];
 
-		regs->sim_RWDecoder();
-
 		wire.RES = NOT(inputs[(size_t)InputPad::n_RES]);
 
 		if (wire.RES == TriState::One)
@@ -4608,11 +5343,24 @@ namespace PPUSim
 		Reset_FF.set(NOR(fsm.RESCL, NOR(wire.RES, Reset_FF.get())));
 		wire.RC = NOT(Reset_FF.nget());
 
-		sim_BusInput(ext, data_bus, ad_bus);
+		// PCLK phase scheduler.
+		// Most of the half-cycles only move the PCLK divider. If PCLK has not changed and the CPU interface is not selected (/DBE = 1 now and on the previous half-cycle),
+		// the register block and the bus terminals would only reproduce their previous state, so they are skipped.
+
+		bool idle = Prev_PCLK == wire.PCLK && wire.n_DBE == TriState::One && Prev_n_DBE == TriState::One && wire.RC == Prev_RC;
+		Prev_n_DBE = wire.n_DBE;
+		Prev_RC = wire.RC;
+
+		if (!idle)
+		{
+			regs->sim_RWDecoder();
 
-		// Regs
+			sim_BusInput(ext, data_bus, ad_bus);
 
-		regs->sim();
+			// Regs
+
+			regs->sim();
+		}
 
 		if (Prev_PCLK != wire.PCLK)
 		{
@@ -4658,7 +5406,12 @@ namespace PPUSim
 			Prev_PCLK = wire.PCLK;
 		}
 
-		vid_out->sim(vout);
+		// The composite phase shifter runs on CLK, but the RAW output only changes with PCLK.
+
+		if (!(idle && vid_out->IsRAWOutput()))
+		{
+			vid_out->sim(vout);
+		}
 
 		// Output terminals
 
@@ -4667,7 +5420,10 @@ namespace PPUSim
 		outputs[(size_t)OutputPad::n_RD] = NOT(wire.RD);
 		outputs[(size_t)OutputPad::n_WR] = NOT(wire.WR);
 
-		sim_BusOutput(ext, data_bus, ad_bus, addrHi_bus);
+		if (!idle)
+		{
+			sim_BusOutput(ext, data_bus, ad_bus, addrHi_bus);
+		}
 	}
 
 	void PPU::sim_BusInput(uint8_t* ext, uint8_t* data_bus, uint8_t* ad_bus)
@@ -4749,6 +5505,16 @@ namespace PPUSim
 			*data_bus = DB;
 		}
 
+		if (HLE_Mode)
+		{
+			if (wire.RD == TriState::Zero)
+			{
+				*ad_bus = (uint8_t)PA;
+			}
+			*addrHi_bus = (uint8_t)(PA >> 8);
+			return;
+		}
+
 		if (wire.RD == TriState::Zero)
 		{
 			uint8_t PABot = 0;
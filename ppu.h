@@ -165,6 +165,23 @@ namespace PPUSim
 
 		BaseLogic::TriState unused[8]{};
 
+		// HLE. Each color bit has its shift registers packed into 16 bits (SR1 in the high byte, SR2 or SRBit1 in the low byte/bit 8).
+
+		bool HLE = false;
+
+		struct HLEState
+		{
+			uint16_t in[4];			// in_latch of the shift register bits
+			uint16_t out[4];		// out_latch (uninverted)
+			uint8_t BGC0_PD;		// BGC0_Latch
+			uint8_t PD_SEL;			// pd_latch
+			uint8_t bgc_latch1;		// bgcX_latch[0], packed
+			uint8_t bgc_latch2;		// bgcX_latch[1], packed
+			bool fat_latch;
+			bool tho1_latch;
+			bool clpb_latch;
+		} hle{};
+
 		void sim_Control();
 		void sim_BGC0();
 		void sim_BGC1();
@@ -172,8 +189,12 @@ namespace PPUSim
 		void sim_BGC3();
 		void sim_Output();
 
+		void sim_Gates();
+		void sim_HLE();
+		void sim_Lockstep();
+
 	public:
-		BGCol(PPU* parent);
+		BGCol(PPU* parent, bool hle_mode);
 		~BGCol();
 
 		void sim();
@@ -848,17 +869,42 @@ namespace PPUSim
 		BaseLogic::TriState VINV = BaseLogic::TriState::X;
 		BaseLogic::TriState inv_bits_out[4]{};
 
+		// HLE
+
+		bool HLE = false;
+
+		struct HLEState
+		{
+			uint8_t OB;				// ob_latch/ob0_latch
+			uint8_t PD_in;			// pdin_latch (uninverted)
+			uint8_t PD_out;			// pdout_latch
+			uint8_t OV_in;			// in_latch of ParBitInv
+			uint8_t OV_out;			// out_latch of ParBitInv (uninverted)
+			uint16_t PAT_ADR;		// padX_latch (uninverted), bits 3 and 13 are not latched
+			bool fnt_latch;
+			bool VINV_FF;
+		} hle{};
+
 		void sim_Control();
 		void sim_VInv();
 		void sim_ParBitsInv();
 		void sim_ParBit4();
 		void sim_ParBits();
 
+		void sim_Gates();
+		void sim_HLE();
+		void sim_Lockstep();
+
 	public:
-		PAR(PPU* parent);
+		PAR(PPU* parent, bool hle_mode);
 		~PAR();
 
 		void sim();
+
+		/// <summary>
+		/// Packed pattern address (HLE only).
+		/// </summary>
+		uint16_t get_PAT_ADR();
 	};
 
 	// Tile Counters (nesdev `v`)
@@ -972,10 +1018,29 @@ namespace PPUSim
 		BaseLogic::TriState NT_ADR[14]{};
 		BaseLogic::TriState PAT_ADR[14]{};
 
+		// HLE. The addresses are formed as uint16_t.
+
+		bool HLE = false;
+
+		struct HLEState
+		{
+			uint16_t AT_ADR;
+			uint16_t NT_ADR;
+			uint16_t PAT_ADR;
+			uint16_t in;			// in_latch of the mux bits
+			bool PARR;
+			bool PAH;
+			bool PAL;
+		} hle{};
+
 		void sim_Control();
 
+		void sim_ControlHLE();
+		void sim_MuxInputsHLE();
+		void sim_MuxOutputsHLE();
+
 	public:
-		PAMUX(PPU* parent);
+		PAMUX(PPU* parent, bool hle_mode);
 		~PAMUX();
 
 		void sim();
@@ -1202,8 +1267,53 @@ namespace PPUSim
 		BaseLogic::DLatch OB_latch[8];
 		BaseLogic::DLatch ovz_latch;
 
+		// HLE. The same circuits, but the counters, the comparator and all the latches are kept as packed integers and bools.
+
+		bool HLE = false;
+
+		struct HLEState
+		{
+			uint8_t i2;				// Johnson counter latches (bit n = i2_latch[n])
+			uint8_t OB;				// OB_latch
+			uint8_t MainKeep;		// keep_ff of MainCounter bits
+			uint8_t MainCnt;		// cnt_latch of MainCounter bits
+			uint8_t TempKeep;		// keep_ff of TempCounter bits
+			uint8_t TempCnt;		// cnt_latch of TempCounter bits
+			bool OVZ;
+			bool OMFG;
+			bool OMSTEP;
+			bool W3_Enable;
+			bool blnk_latch;
+			bool W3_FF1;
+			bool W3_FF2;
+			bool w3_latch1;
+			bool w3_latch2;
+			bool w3_latch3;
+			bool w3_latch4;
+			bool init_latch;
+			bool ofetch_latch;
+			bool omv_latch;
+			bool eval_latch;
+			bool tmv_latch;
+			bool nomfg_latch;
+			bool ioam2_latch;
+			bool temp_latch1;
+			bool omfg_latch;
+			bool setov_latch;
+			bool OAMCTR2_FF;
+			bool SPR_OV_REG_FF;
+			bool SPR_OV_FF;
+			bool eval_FF1;
+			bool eval_FF2;
+			bool eval_FF3;
+			bool fnt_latch;
+			bool novz_latch;
+		} hle{};
+
 		// The blocks are simulated in the signal propagation order as the developers intended or we think they intended.
 
+		void sim_Gates();
+
 		void sim_StepJohnson();
 		void sim_Comparator();
 		void sim_ComparisonFSM();
@@ -1219,8 +1329,18 @@ namespace PPUSim
 
 		BaseLogic::TriState get_SPR_OV();
 
+		/// <summary>
+		/// Sprite comparison on integers. Produces the same OAM address, OV, PD_FIFO, SPR_OV, /SPR0_EV and OAMCTR2 on each PCLK as the gate-level model.
+		/// </summary>
+		void sim_HLE();
+
+		/// <summary>
+		/// Debug: run HLE and the gate-level model side by side and make sure their outputs match.
+		/// </summary>
+		void sim_Lockstep();
+
 	public:
-		ObjEval(PPU* parent);
+		ObjEval(PPU* parent, bool hle_mode);
 		~ObjEval();
 
 		void sim();
@@ -1250,7 +1370,7 @@ namespace PPUSim
 		BaseLogic::FF ff[3]{};
 
 	public:
-		void sim(BaseLogic::TriState PCLK, BaseLogic::TriState n_Tx, BaseLogic::TriState col_in[12], BaseLogic::TriState lum_in[2]);
+		void sim(BaseLogic::TriState PCLK, BaseLogic::TriState n_Tx, const BaseLogic::TriState col_in[12], BaseLogic::TriState lum_in[2]);
 
 		void getOut(BaseLogic::TriState col_out[3]);
 	};
@@ -1276,24 +1396,20 @@ namespace PPUSim
 		BaseLogic::DLatch npicture_latch1;
 		BaseLogic::DLatch npicture_latch2;
 		BaseLogic::DLatch v0_latch;
-		const size_t chroma_decoder_inputs = 10;
-		const size_t chroma_decoder_outputs = 12 * 2 + 1;	// 12*2 phases + 1 for grays
-		BaseLogic::PLA* chroma_decoder = nullptr;
+		const uint32_t* chroma_decoder = nullptr;	// Chroma decoder lanes (12*2 phases + 1 for grays), indexed by packed V0 and CC0-3
 
 		// For RGB PPU
 		BaseLogic::DLatch rgb_sync_latch[3]{};
 		BaseLogic::DLatch rgb_red_latch[8]{};
 		BaseLogic::DLatch rgb_green_latch[8]{};
 		BaseLogic::DLatch rgb_blue_latch[8]{};
-		BaseLogic::TriState* rgb_output;
+		const BaseLogic::TriState* rgb_output = nullptr;
 		RGB_SEL12x3 red_sel;
 		RGB_SEL12x3 green_sel;
 		RGB_SEL12x3 blue_sel;
 
 		// RGB PPU Color Matrix
-		const size_t color_matrix_inputs = 16;
-		const size_t color_matrix_outputs = 12 * 3;	// R->G->B
-		BaseLogic::PLA* color_matrix = nullptr;
+		const BaseLogic::TriState* color_matrix = nullptr;	// Color matrix lanes (12*3 outputs, R->G->B), indexed by the packed CC2-3 and /LL0-1
 
 		VideoOutSRBit sr[6]{};		// Individual bits of the shift register for the phase shifter.
 
@@ -1356,25 +1472,9 @@ namespace PPUSim
 
 		bool IsComposite();
 
-		void SetCompositeNoise(float volts);
-	};
+		bool IsRAWOutput();
 
-	union PALChromaInputs
-	{
-		struct
-		{
-			unsigned n_V0 : 1;
-			unsigned V0 : 1;
-			unsigned n_CC0 : 1;
-			unsigned CC0 : 1;
-			unsigned n_CC1 : 1;
-			unsigned CC1 : 1;
-			unsigned n_CC2 : 1;
-			unsigned CC2 : 1;
-			unsigned n_CC3 : 1;
-			unsigned CC3 : 1;
-		};
-		size_t packed_bits;
+		void SetCompositeNoise(float volts);
 	};
 
 	// VRAM Controller
@@ -1701,6 +1801,10 @@ namespace PPUSim
 		BaseLogic::DLatch pclk_6;	// PAL PPU
 		size_t pclk_counter = 0;
 		BaseLogic::TriState Prev_PCLK = BaseLogic::TriState::X;
+		BaseLogic::TriState Prev_n_DBE = BaseLogic::TriState::X;		// The values from the previous half-cycle, for the PCLK phase scheduler
+		BaseLogic::TriState Prev_RC = BaseLogic::TriState::X;
+
+		bool HLE_Mode = false;		// Acceleration mode. Some of the circuits are simulated on integers with the same cycle-exact result.
 
 		ControlRegs* regs = nullptr;
 		HVCounter* h = nullptr;
@@ -1720,6 +1824,7 @@ namespace PPUSim
 
 		uint8_t DB = 0;				// CPU I/F Data bus
 		uint8_t PD = 0;				// Internal PPU Data bus
+		uint16_t PA = 0x3fff;		// PPU address (PA0-13) formed by PAMUX. HLE only, otherwise use the /PA wires. The PAMUX output latches are reset to 0 (inverted).
 
 		void sim_BusInput(uint8_t* ext, uint8_t* data_bus, uint8_t* ad_bus);
 		void sim_BusOutput(uint8_t* ext, uint8_t* data_bus, uint8_t* ad_bus, uint8_t* addrHi_bus);
@@ -1727,7 +1832,7 @@ namespace PPUSim
 		BaseLogic::DLatch extout_latch[4]{};
 
 	public:
-		PPU(Revision rev, bool VideoGen = false);
+		PPU(Revision rev, bool VideoGen = false, bool HLE = false);
 		~PPU();
 
 		/// <summary>
@@ -31,6 +31,23 @@ SoundOutput::SoundOutput()
 	memset(SampleBuf, 0, SampleBuf_Size * sizeof(int16_t));
 	SampleBuf_Ptr = 0;
 
+	for (size_t n = 0; n < 2; n++)
+	{
+		BlockData[n] = new APUSim::AudioOutSignal[BlockSize];
+		CartData[n] = new float[BlockSize];
+		memset(CartData[n], 0, BlockSize * sizeof(float));
+		Blocks.blocks[n] = BlockData[n];
+		Blocks.cart[n] = CartData[n];
+	}
+	Decimated = new APUSim::AudioOutSignal[BlockSize / DecimateEach + 1];
+	DecimatedCart = new float[BlockSize / DecimateEach + 1];
+	Mixed = new float[BlockSize / DecimateEach + 1];
+
+	Blocks.size = BlockSize;
+	Blocks.callback = BlockReady;
+	Blocks.opaque = this;
+	SetAudioBlocks(&Blocks);
+
 	if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
 		printf("SDL audio could not initialize! SDL_Error: %s\n", SDL_GetError());
 		return;
@@ -51,7 +68,15 @@ SoundOutput::~SoundOutput()
 {
 	SDL_CloseAudioDevice(dev_id);
 	SDL_QuitSubSystem(SDL_INIT_AUDIO);
+	SetAudioBlocks(nullptr);
 	delete[] SampleBuf;
+	delete[] BlockData[0];
+	delete[] BlockData[1];
+	delete[] CartData[0];
+	delete[] CartData[1];
+	delete[] Decimated;
+	delete[] DecimatedCart;
+	delete[] Mixed;
 }
 
 void SoundOutput::Mixer(void* thisptr, Uint8* stream, int len)
@@ -67,27 +92,41 @@ void SoundOutput::Mixer(void* thisptr, Uint8* stream, int len)
 	}
 }
 
-void SoundOutput::FeedSample()
+void SoundOutput::BlockReady(APUSim::AudioBlocks* blocks, void* opaque)
 {
-	if (DecimateCounter >= DecimateEach)
+	SoundOutput* snd_out = (SoundOutput*)opaque;
+	snd_out->ProcessBlock(blocks->blocks[blocks->current ^ 1], blocks->cart[blocks->current ^ 1], blocks->size);
+	blocks->ready = false;
+}
+
+void SoundOutput::ProcessBlock(const APUSim::AudioOutSignal* block, const float* cart, size_t size)
+{
+	// Take one sample and skip the next DecimateEach, then mix the taken samples all at once.
+
+	size_t count = 0;
+	size_t pos = DecimateCounter;
+
+	while (pos < size)
 	{
-		float sample;
-		{
-			SampleAudioSignal(&sample);
-		}
+		Decimated[count] = block[pos];
+		DecimatedCart[count] = cart[pos];
+		count++;
+		pos += DecimateEach + 1;
+	}
+
+	DecimateCounter = (int)(pos - size);
 
-		SampleBuf[SampleBuf_Ptr++] = (int16_t)(sample * (float)INT16_MAX);
-		DecimateCounter = 0;
+	MixAudioSignal(Decimated, DecimatedCart, Mixed, count);
+
+	for (size_t n = 0; n < count; n++)
+	{
+		SampleBuf[SampleBuf_Ptr++] = (int16_t)(Mixed[n] * (float)INT16_MAX);
 
 		if (SampleBuf_Ptr >= SampleBuf_Size)
 		{
 			Playback();
 		}
 	}
-	else
-	{
-		DecimateCounter++;
-	}
 }
 
 /// <summary>
@@ -27,14 +27,25 @@ class SoundOutput
 	SDL_AudioDeviceID dev_id;
 
 	static void SDLCALL Mixer(void* unused, Uint8* stream, int len);
+	static void BlockReady(APUSim::AudioBlocks* blocks, void* opaque);
 
 	void Redecimate();
 	void Playback();
 
 	int DecimateEach;
-	int DecimateCounter;
+	int DecimateCounter;		// Position of the next taken sample in the block
 	const int OutputSampleRate = 48000;
 
+	// The APU output is collected in blocks (see SetAudioBlocks)
+
+	static const size_t BlockSize = 0x10000;
+	APUSim::AudioOutSignal* BlockData[2]{};
+	float* CartData[2]{};
+	APUSim::AudioBlocks Blocks{};
+	APUSim::AudioOutSignal* Decimated;
+	float* DecimatedCart;
+	float* Mixed;
+
 	int16_t* SampleBuf;
 	int SampleBuf_Ptr;
 	int SampleBuf_Size;
@@ -50,5 +61,5 @@ public:
 	/// The AUX output is sampled at a high frequency, which cannot be played by a ordinary sound card.
 	/// Therefore, some of the samples are skipped to match the playback frequency.
 	/// </summary>
-	void FeedSample();
+	void ProcessBlock(const APUSim::AudioOutSignal* block, const float* cart, size_t size);
 };
\ No newline at end of file
@@ -60,4 +60,9 @@ namespace BaseBoard
 			}
 		}
 	}
+
+	uint8_t* SRAM::GetMemory()
+	{
+		return mem;
+	}
 }
\ No newline at end of file
@@ -44,5 +44,11 @@ namespace BaseBoard
 		/// <param name="data">inOut: Data Bus</param>
 		/// <param name="dz">inOut: dz ("Data Z") determines whether the data bus to which the SRAM is attached is dirty or not. This is analogous to the z state of the bus (in Verilog terms). dz = true means that the bus is "floating".</param>
 		void sim(BaseLogic::TriState n_CS, BaseLogic::TriState n_WE, BaseLogic::TriState n_OE, uint32_t* addr, uint8_t* data, bool& dz);
+
+		/// <summary>
+		/// Direct access to the memory cells (bypassing the chip terminals). Used by the motherboard fast paths.
+		/// </summary>
+		/// <returns>Pointer to the memory array of the size specified in the constructor.</returns>
+		uint8_t* GetMemory();
 	};
 }
\ No newline at end of file
@@ -78,6 +78,17 @@ namespace Mappers
 		return valid;
 	}
 
+	bool UNROM::GetPPUMemoryMap(PPUMemoryMap& map)
+	{
+		for (size_t n = 0; n < 8; n++)
+		{
+			map.chr[n] = &CHR[n * 0x400];
+			map.chr_writable[n] = true;
+			map.vram_a10[n] = V_Mirroring ? (n & 1) : ((n >> 1) & 1);
+		}
+		return true;
+	}
+
 	void UNROM::sim(
 		TriState cart_in[(size_t)CartInput::Max],
 		TriState cart_out[(size_t)CartOutput::Max],
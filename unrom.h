@@ -57,5 +57,7 @@ namespace Mappers
 			CartAudioOutSignal* snd_out,
 			// NES only
 			uint16_t* exp, bool& exp_dirty);
+
+		bool GetPPUMemoryMap(PPUMemoryMap& map) override;
 	};
 }
\ No newline at end of file